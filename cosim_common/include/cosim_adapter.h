@@ -12,11 +12,17 @@
 #include <string>
 #include <list>
 #include <map>
+#include <set>
+#include <deque>
+#include <vector>
+#include <unordered_map>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/optional/optional.hpp>
 #include <systemc>
 #include "schd_sig_ptree.h"
 #include "simd_sig_ptree.h"
+#include "cosim_stat.h"
+#include "cosim_msg.h"
 
 // Short alias for the namespace
 namespace boost_pt = boost::property_tree;
@@ -32,6 +38,7 @@ namespace schd {
       sc_core::sc_port<sc_core::sc_fifo_in_if< simd::simd_sig_ptree_c>> event_i;    // SIMD Interrupt request fifo export through the input interface
       sc_core::sc_port<sc_core::sc_fifo_out_if<simd::simd_sig_ptree_c>> busw_o;     // SIMD Config output
       sc_core::sc_port<sc_core::sc_fifo_in_if< simd::simd_sig_ptree_c>> busr_i;     // SIMD Status input
+      sc_core::sc_port<sc_core::sc_signal_inout_if<bool>, 1, sc_core::SC_ZERO_OR_MORE_BOUND> clock_o; // Gated clock of the SIMD core (optional)
 
       // ports to be connected to SCHD planner (via router)
       sc_core::sc_export<sc_core::sc_fifo_in_if <schd::schd_sig_ptree_c>> plan_ei;
@@ -43,18 +50,110 @@ namespace schd {
       // Init/config declaration
       void init(
             boost::optional<const boost_pt::ptree&> schd_exec_p,        // SCHD exec preferences
-            boost::optional<const boost_pt::ptree&> simd_core_p );      // SIMD core preferences
+            boost::optional<const boost_pt::ptree&> simd_core_p,        // SIMD core preferences
+            boost::optional<const boost_pt::ptree&> adpt_pref_p );      // Adapter preferences (optional)
 
       void add_trace(
             sc_core::sc_trace_file* tf,
             const std::string& top_name );
 
+      // SIMD core is clocked from clock_o
+      bool gate_enabled(
+            void ) const;
+
+      void end_of_simulation(
+            void );
+
+      // Statistics. Counters are not updated unless enabled
+      void stat_enable(
+            void );
+
+      boost_pt::ptree& stat_get(
+            boost_pt::ptree&                     stat_pt ) const;
+
+      // Heartbeat. Jobs in flight and jobs completed so far. Counted without the statistics
+      std::size_t job_actv_get(
+            void ) const;
+
+      std::uint64_t job_done_get(
+            void ) const;
+
+      // Partitioned simulation (see cosim_part.h)
+      enum part_mode_t {
+         PART_NONE,  // Adapter is complete
+         PART_PLAN,  // Planner side: latency stages only. The rest of the adapter is in the SIMD core process
+         PART_SIMD   // SIMD core side: everything except the latency stages
+      };
+
+      class dly_data_t {
+      public:
+         sc_core::sc_time                        due;  // Time when the packet leaves the latency stage
+         cosim_msg_c                             msg;
+      };
+
+      typedef std::deque<dly_data_t> dly_list_t;
+
+      void part_set(
+            part_mode_t                          mode );
+
+      const sc_core::sc_time& latency_get(
+            void ) const;
+
+      // Move packets between the halves of the adapter in the different processes
+      void part_plan_take(                                      // PART_PLAN: packets from planner
+            dly_list_t&                          dly_list );
+
+      void part_plan_give(                                      // PART_SIMD: packets from planner
+            dly_list_t&                          dly_list );
+
+      void part_done_take(                                      // PART_SIMD: completions to planner
+            dly_list_t&                          dly_list );
+
+      void part_done_give(                                      // PART_PLAN: completions to planner
+            dly_list_t&                          dly_list );
 
    private:
       // Process declarations
       void exec_thrd(
             void );
 
+      void plan_thrd(
+            void );
+
+      void done_thrd(
+            void );
+
+      void gate_mthd(
+            void );
+
+      bool plan_avail(
+            void );
+
+      void plan_read(
+            void );
+
+      void done_write(
+            const cosim_msg_c& done_msg );
+
+      void done_flush(                                          // Retries the staged completions
+            void );
+
+      bool exec_idle(
+            void );
+
+      bool exec_ready(                                          // Inputs can be processed at this step
+            void );
+
+      bool busw_wait(                                           // Config words are staged until the core reads busw_o
+            void );
+
+      // Loosely-timed mode. Local time of the adapter and synchronization with the kernel
+      sc_core::sc_time time_local(
+            void ) const;
+
+      void lt_sync(
+            void );
+
       // Channels
       sc_core::sc_fifo<schd_sig_ptree_c> chn_adap_plan;
       sc_core::sc_fifo<schd_sig_ptree_c> chn_plan_adap;
@@ -64,33 +163,238 @@ namespace schd {
 
       std::string core_name;
 
-      class cliq_data_t; // Forward declaration
-      typedef std::map<std::size_t,cliq_data_t> cliq_evnt_list_t;
+      // Adapter preferences
+      std::size_t conf_burst = 1;  // Config words written to busw_o per clock cycle (modelled bus width), 0: whole config list
+      std::size_t evnt_drain = 1;  // Packets read from event_i and from busr_i per clock cycle, 0: all available
+      bool        wake_evnt  = false; // Sleep until an input fifo is written instead of waking on every clock edge
+      std::size_t cliq_slots = 0;  // Capacity of the clique table, 0: number of the executors
+      sc_core::sc_time plan_dly;   // Latency of the planner<->adapter paths, zero: no latency stages
+      bool        lt_mode    = false; // Loosely-timed: whole jobs per step, runs ahead of the kernel up to lt_quantum
+      sc_core::sc_time lt_quantum; // Time quantum of the loosely-timed mode
+      sc_core::sc_time lt_cycle;   // Clock period, measured when the adapter starts
+      sc_core::sc_time lt_offset;  // Local time ahead of the kernel
+      bool        busw_full  = false; // busw_o was full at the last write. The rest of the config list is staged
+      std::size_t core_rec_idx = static_cast<std::size_t>( -1 ); // Core name in the recording
+      bool        rply_en    = false; // Replay: jobs are completed after the recorded latency, no SIMD core
+      std::size_t gate_idle  = 0;  // Idle clock cycles before the clock of the SIMD core is stopped, 0: no gating
+      std::size_t gate_cnt   = 0;  // Idle clock cycles so far
+      bool        gate_stop  = false; // Core is idle. Clock is stopped at the next falling edge
+      bool        gate_run   = true;  // clock_o follows clock_i
+      sc_core::sc_event gate_wake_evnt;
+      sc_core::sc_time  gate_stop_time;
+      std::size_t job_actv   = 0;  // Outstanding jobs
+      std::uint64_t job_done = 0;  // Completed jobs
+
+      // Credit-based flow control. Jobs are streamed to a DME/EU block only while it has free config slots
+      enum credit_mode_t {
+         CREDIT_NONE,    // No flow control
+         CREDIT_EVENT,   // Config slot is freed by the event of the block
+         CREDIT_STATUS   // Free config slots are reported by the block in the status packets
+      };
+
+      credit_mode_t credit_mode = CREDIT_NONE;
+      std::multimap<sc_core::sc_time, std::size_t> rply_list; // Completion time and event id of the jobs completed without the SIMD core (replay, memoization)
+
+      part_mode_t      part_mode = PART_NONE;
+      dly_list_t       plan_dly_list;  // Packets from planner in the latency stage
+      dly_list_t       done_dly_list;  // Completions to planner in the latency stage
+      std::deque<cosim_msg_c> done_stage; // Completions waiting for space in chn_adap_plan
+      sc_core::sc_event plan_dly_evnt;
+      sc_core::sc_event done_dly_evnt;
 
       class evnt_data_t {
       public:
          std::string                                     event;
-         boost::optional<cliq_evnt_list_t::value_type &> clique_p;    // Members of the clique report together (with the last event received)
+         cosim_msg_c                                     done_msg;     // Completion packet for the planner, built at init
+         bool                                            conf = false; // Virtual configuration dmeu
+         std::size_t                                     cliq_idx;     // Slot of the clique. Members of the clique report together (with the last event received)
          std::size_t                                     job_hash = 0;
+         std::size_t                                     trce_idx = static_cast<std::size_t>( -1 ); // Signal in the binary trace
+         std::size_t                                     rec_idx  = static_cast<std::size_t>( -1 ); // Name in the recording
+         std::size_t                                     memo_sig = 0; // Signature of the job whose latency is measured, 0: none
+         std::size_t                                     blck_idx = static_cast<std::size_t>( -1 ); // Block with the credit-based flow control
+         bool                                            blck_slot = false; // Job took a config slot of the block
+         sc_core::sc_time                                disp_time;    // Time when the job was dispatched
       };
 
       class cliq_data_t {
       public:
          std::string                               clique;
-         std::size_t                               evnt_count = 0;
-         std::list<boost::optional<evnt_data_t &>> evnt_ptr_list;
+         std::size_t                               cliq_hash  = 0;
+         std::size_t                               actv_pos   = 0;  // Position in the list of the active slots
+         std::size_t                               evnt_count = 0;  // Outstanding events
+         std::size_t                               memb_count = 0;  // Members in memb_list
+         std::vector<std::size_t>                  memb_list;       // Event ids of the members. Grows on demand and keeps its capacity
+         sc_core::sc_time                          start_time;      // Time when the first member was dispatched
+      };
+
+      class job_data_t {
+      public:
+         std::string                               thread;
+         std::string                               task;
+         std::string                               param;
+         std::size_t                               job_hash = 0;
+      };
+
+      class blck_data_t {
+      public:
+         std::string                               block;           // core.dmeu
+         std::size_t                               slots  = 0;      // config_slots of the block
+         std::size_t                               credit = 0;      // Free config slots
+         std::size_t                               pend   = 0;      // Status mode: slots taken by the jobs whose config list the core has not read yet
+         std::deque<cosim_msg_c>                   park_list;       // Jobs waiting for a free config slot
+      };
+
+      class ready_data_t {
+      public:
+         std::size_t                               blck_idx;
+         cosim_msg_c                               msg;
       };
 
-      typedef std::map<std::size_t,evnt_data_t> evnt_cliq_list_t;
+      class pend_data_t {
+      public:
+         std::uint64_t                             busw_last;       // Last config word of the job in the count of busw_o words
+         std::size_t                               blck_idx;
+      };
+
+      typedef std::vector<evnt_data_t>                     evnt_list_t;
+      typedef std::unordered_map<std::size_t,std::size_t> evnt_idx_list_t;
+      typedef std::unordered_map<std::size_t,job_data_t>  job_hash_list_t;
+      typedef std::vector<cliq_data_t>                     cliq_pool_t;
+      typedef std::vector<std::size_t>                     slot_list_t;
+
+      evnt_list_t      evnt_list;       // event info. Dense, indexed by event id. Not resized after init
+      evnt_idx_list_t  evnt_idx_list;   // maps event  hash to event id
+      cliq_pool_t      cliq_pool;       // Clique slab. Slots are recycled between jobs
+      slot_list_t      cliq_free;       // Free clique slots
+      slot_list_t      cliq_actv;       // Clique slots in use
+      job_hash_list_t  job_hash_list;   // maps thread/task/param hash to job hash
+      std::vector<blck_data_t> blck_list;   // Blocks with the credit-based flow control
+      evnt_idx_list_t  blck_idx_list;   // maps block hash to block id
+      std::deque<ready_data_t> conf_ready;  // Parked jobs which got a credit. Streamed before the new jobs
+      std::deque<pend_data_t>  pend_list;   // Status mode: jobs with a config slot whose config words are in busw_o
+      std::size_t      park_hold = 0;       // Blocks with more than one parked job. The planner is not read while non-zero
+      std::size_t      plan_blck = static_cast<std::size_t>( -1 ); // Block of the job being streamed
+      std::uint64_t    busw_cnt  = 0;       // Config words written to busw_o
+      std::size_t      busw_size = 0;       // Capacity of busw_o
+
+      static const std::size_t evnt_none = static_cast<std::size_t>( -1 );
+      static const std::size_t cliq_none = static_cast<std::size_t>( -1 );
+      static const std::size_t blck_none = static_cast<std::size_t>( -1 );
+
+      // Statistics
+      std::size_t      cliq_peak = 0;   // Peak number of the outstanding cliques
+
+      class lat_data_t {
+      public:
+         std::uint64_t                             count = 0;
+         sc_core::sc_time                          sum;
+         sc_core::sc_time                          min;
+         sc_core::sc_time                          max;
+      };
+
+      bool             stat_en         = false;
+      std::uint64_t    stat_cycle      = 0;   // Active clock cycles
+      std::uint64_t    stat_disp       = 0;   // Jobs dispatched
+      std::uint64_t    stat_done       = 0;   // Jobs completed
+      std::uint64_t    stat_conf       = 0;   // Config words written to busw_o
+      std::uint64_t    stat_evnt       = 0;   // Packets read from event_i
+      std::uint64_t    stat_busr       = 0;   // Packets read from busr_i
+      std::uint64_t    stat_busw_stall = 0;   // Cycles with the config words staged, busw_o is full
+      std::uint64_t    stat_done_stall = 0;   // Cycles with the completions staged, chn_adap_plan is full
+      std::uint64_t    stat_lt_sync    = 0;   // Synchronizations with the kernel in the loosely-timed mode
+      std::uint64_t    stat_gate_stop  = 0;   // Clock of the SIMD core was stopped
+      std::uint64_t    stat_credit_wait = 0;  // Jobs parked until their block had a free config slot
+      sc_core::sc_time stat_gate_time;        // Time with the clock of the SIMD core stopped
+      cosim_hist_c     hist_plan_depth;       // Packets from planner waiting (per active cycle)
+      cosim_hist_c     hist_done_depth;       // Completions waiting for planner (per active cycle)
+      cosim_hist_c     hist_evnt_depth;       // event_i occupancy (per active cycle)
+      cosim_hist_c     hist_busr_depth;       // busr_i occupancy (per active cycle)
+      cosim_hist_c     hist_job_lat;          // Dispatch to completion, time resolution units
+      cosim_hist_c     hist_cliq_lat;         // First dispatch to completion of the clique, time resolution units
+      typedef std::unordered_map<std::size_t,lat_data_t>  lat_list_t;
+
+      lat_list_t       job_lat_list;          // Latency by job hash
+
+      // Memoization of the job latency. Jobs simulated memo_count times with the same latency are not sent to the core
+      class memo_data_t {
+      public:
+         sc_core::sc_time                          lat;
+         std::size_t                               count = 0;  // Detailed runs with this latency
+      };
+
+      typedef std::unordered_map<std::size_t,memo_data_t> memo_list_t;
+
+      std::size_t      memo_count = 0;        // 0: disabled
+      std::string      memo_file;             // Persistent cache of the core, empty: none
+      memo_list_t      memo_list;             // by job signature: job hash and options of the job
+      std::string      memo_buf;
+      std::uint64_t    stat_memo_hit  = 0;    // Jobs completed with the cached latency
+      std::uint64_t    stat_memo_miss = 0;    // Jobs simulated in detail
+
+      std::size_t memo_sig_get(
+            std::size_t            job_hash,
+            const boost_pt::ptree& optn_pt );
+
+      void memo_add(
+            std::size_t             memo_sig,
+            const sc_core::sc_time& lat );
+
+      void memo_load(
+            void );
+
+      void memo_save(
+            void ) const;
+
+      // Name hashing (FNV-1a) which can be computed over the parts of a name without concatenating them
+      static std::size_t name_hash(
+            std::size_t        seed,
+            const std::string& str );
+
+      static const std::string* child_data(
+            const boost_pt::ptree& pt,
+            const std::string&     key );
+
+      std::size_t evnt_find(
+            std::size_t        evnt_hash ) const;
+
+      bool evnt_match(
+            const std::string& event,
+            const std::string& src,
+            const std::string& evnt_id ) const;
+
+      std::size_t cliq_get(
+            const std::string& clique );
+
+      void cliq_release(
+            std::size_t        cliq_idx );
+
+      std::size_t blck_find(                                    // Block of the status packet
+            const std::string& src ) const;
+
+      void credit_set(                                          // Free config slots of the block. Hands them to the parked jobs
+            std::size_t        blck_idx,
+            std::size_t        credit );
+
+      void pend_retire(                                         // Config lists which the core has read from busw_o
+            void );
+
+      std::size_t job_hash_get(
+            const std::string& thrd,
+            const std::string& task,
+            const std::string& prid );
 
-      evnt_cliq_list_t evnt_cliq_list;  // maps event  hash to clique info
-      cliq_evnt_list_t cliq_evnt_list;  // maps clique hash to event  info
+      void job_hash_set(
+            evnt_data_t&       evnt_data,
+            std::size_t        job_hash );
 
-      boost_pt::ptree plan_pt;
-      boost_pt::ptree evnt_pt;
-      boost_pt::ptree stat_pt;
-      boost::optional<boost_pt::ptree &> conf_p;
-      boost_pt::ptree::iterator          conf_it;
+      cosim_msg_c plan_msg;                                 // Packet from planner being dispatched. Shared with the latency stage
+      std::vector<simd::simd_sig_ptree_c> evnt_sig_list;    // Packets read from event_i. Reused from cycle to cycle
+      std::vector<simd::simd_sig_ptree_c> stat_sig_list;    // Packets read from busr_i. Reused from cycle to cycle
+      std::size_t evnt_sig_num = 0;
+      std::size_t stat_sig_num = 0;
+      boost::optional<const boost_pt::ptree &> conf_p;
+      boost_pt::ptree::const_iterator          conf_it;
    };
 }
 
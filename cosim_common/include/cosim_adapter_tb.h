@@ -0,0 +1,181 @@
+/*
+ * cosim_adapter_tb.h
+ *
+ *  Description:
+ *    Standalone testbench of the SCHD<->SIMD adapter. The stub planner sends jobs
+ *    to the adapter according to the list of tests and checks the completions. The
+ *    stub SIMD core checks the config words of each job and replies with the event
+ *    and status packets. Host time per packet of each test is reported. Tests with
+ *    their own adapter preferences run on their own lane: adapter, stub SIMD core
+ *    and channels. Only the lane of the running test is clocked
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_ADAPTER_TB_H_
+#define COSIM_COMMON_INCLUDE_COSIM_ADAPTER_TB_H_
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+#include <systemc>
+#include "schd_sig_ptree.h"
+#include "simd_sig_ptree.h"
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_tb_simd_c;
+
+   SC_MODULE( cosim_tb_plan_c ) { // Stub planner
+
+   public:
+      sc_core::sc_in<bool>                                                                  clock_i;  // Clock of the testbench
+      sc_core::sc_vector<sc_core::sc_out<bool>>                                             clock_o;  // Clock of each lane
+      sc_core::sc_vector<sc_core::sc_port<sc_core::sc_fifo_out_if<schd::schd_sig_ptree_c>>> plan_o;   // Jobs to the adapter of each lane
+      sc_core::sc_vector<sc_core::sc_port<sc_core::sc_fifo_in_if< schd::schd_sig_ptree_c>>> done_i;   // Completions from the adapter of each lane
+
+      SC_CTOR( cosim_tb_plan_c );
+
+      void init(
+            boost::optional<const boost_pt::ptree&> tb_pref_p,      // Testbench preferences
+            boost::optional<const boost_pt::ptree&> adpt_pref_p );  // Adapter preferences of the tests without their own
+
+      std::size_t lane_num_get(
+            void ) const;
+
+      // Generated preferences of the lane
+      const std::string& core_name_get(
+            std::size_t                          lane_idx ) const;
+
+      const boost_pt::ptree& exec_pref_get(
+            std::size_t                          lane_idx ) const;
+
+      const boost_pt::ptree& core_pref_get(
+            std::size_t                          lane_idx ) const;
+
+      const boost_pt::ptree& adpt_pref_get(
+            std::size_t                          lane_idx ) const;
+
+      // Config slots of each block of the lane, 0: no flow control
+      std::size_t slots_get(
+            std::size_t                          lane_idx ) const;
+
+      // Stub SIMD core of each lane in the order of the lanes
+      void core_add(
+            const cosim_tb_simd_c&               core );
+
+      // Results of the tests. Number of the failed checks
+      std::size_t result_get(
+            boost_pt::ptree&                     res_pt ) const;
+
+   private:
+      class test_data_t {
+      public:
+         std::string                           name;
+         std::size_t                           jobs     = 1;  // Jobs in the test
+         std::size_t                           blocks   = 1;  // Blocks with the jobs in flight
+         std::size_t                           depth    = 1;  // Jobs in flight per block
+         std::size_t                           clique   = 1;  // Clique width
+         std::size_t                           config   = 1;  // Config words per job
+         std::size_t                           status   = 0;  // Status packets per job
+         std::size_t                           hold     = 1;  // SIMD core releases the events in groups
+         bool                                  reuse    = false; // Jobs of each round repeat the parameters of the first round
+         std::string                           delay;         // SIMD core: last config word to event
+         sc_core::sc_time                      interval;      // Between the jobs
+         sc_core::sc_time                      timeout;       // Waiting for the completions of the round
+         std::size_t                           lane     = 0;
+         bool                                  memo     = false; // Adapter of the lane caches the jobs
+         bool                                  credit   = false; // Adapter of the lane returns a config slot with each event
+         // Results
+         std::size_t                           pckt_num = 0;
+         std::size_t                           err_num  = 0;
+         std::size_t                           core_jobs = 0; // Jobs simulated by the stub SIMD core
+         std::size_t                           slot_wait = 0; // Config lists which found their block without a free config slot
+         double                                host_sec = 0.0;
+         sc_core::sc_time                      sim_time;
+      };
+
+      class lane_data_t {
+      public:
+         std::string                           core_name;
+         std::size_t                           slots    = 0;
+         boost_pt::ptree                       exec_pt;
+         boost_pt::ptree                       core_pt;
+         boost_pt::ptree                       adpt_pt;
+         const cosim_tb_simd_c*                core_p   = nullptr;
+      };
+
+      void exec_thrd(
+            void );
+
+      void clock_mthd(
+            void );
+
+      void test_run(
+            test_data_t&                         test_data );
+
+      void error(
+            test_data_t&                         test_data,
+            const std::string&                   msg );
+
+      std::size_t              blck_num  = 0;
+      std::size_t              dpth_num  = 1;       // Executors per block
+      std::vector<test_data_t> test_list;
+      std::vector<lane_data_t> lane_list;
+      std::size_t              lane_actv = 0;       // Lane of the running test
+      std::size_t              core_idx  = 0;
+   };
+
+   SC_MODULE( cosim_tb_simd_c ) { // Stub SIMD core
+
+   public:
+      sc_core::sc_port<sc_core::sc_fifo_in_if< simd::simd_sig_ptree_c>> busw_i;   // Config words from the adapter
+      sc_core::sc_port<sc_core::sc_fifo_out_if<simd::simd_sig_ptree_c>> event_o;  // Events to the adapter
+      sc_core::sc_port<sc_core::sc_fifo_out_if<simd::simd_sig_ptree_c>> busr_o;   // Status to the adapter
+
+      SC_CTOR( cosim_tb_simd_c );
+
+      void init(
+            std::size_t                          slots );   // Config slots of each block, 0: no limit
+
+      // Jobs started by the core
+      std::size_t job_num_get(
+            void ) const;
+
+      // Config lists which found their block without a free config slot. The core doesn't
+      // read busw_i until the block frees a slot
+      std::size_t slot_wait_get(
+            void ) const;
+
+   private:
+      class evnt_data_t {
+      public:
+         sc_core::sc_time                      due;
+         std::string                           source;
+         std::string                           event_id;
+         std::size_t                           status = 0;
+         std::size_t                           hold   = 1;
+      };
+
+      void busw_thrd(
+            void );
+
+      void evnt_thrd(
+            void );
+
+      std::unordered_map<std::string, std::size_t> word_idx_list;  // Next config word of the block
+      std::unordered_map<std::string, std::size_t> slot_actv_list; // Busy config slots of the block
+      std::deque<evnt_data_t>  evnt_list;
+      sc_core::sc_event        evnt_new;
+      sc_core::sc_event        slot_free;
+      std::size_t              slots    = 0;
+      std::size_t              job_num  = 0;
+      std::size_t              slot_wait = 0;
+   };
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_ADAPTER_TB_H_ */
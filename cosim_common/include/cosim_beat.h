@@ -0,0 +1,76 @@
+/*
+ * cosim_beat.h
+ *
+ *  Description:
+ *    Declaration of the system component:
+ *       Progress heartbeat of the co-simulation. Every period of the simulated
+ *       time writes a JSON line with the simulated and wall time, the simulation
+ *       rate, the delta cycle rate, jobs in flight of each adapter and the resident
+ *       memory. Pauses the simulation and raises the stop flag when the rate drops
+ *       below the threshold or when no job is completed for the stall time. The
+ *       caller of sc_start checks the flag and ends the simulation
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_BEAT_H_
+#define COSIM_COMMON_INCLUDE_COSIM_BEAT_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+#include <systemc>
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_adapter_c;
+
+   SC_MODULE( cosim_beat_c ) { // declare module class
+
+   public:
+      // Constructor declaration
+      SC_CTOR( cosim_beat_c );
+
+      // Init/config declaration
+      void init(
+            boost::optional<const boost_pt::ptree&> cosim_pref_p );  // Co-simulation preferences
+
+      bool enabled(
+            void ) const;
+
+      void add_adapter(
+            cosim_adapter_c&                     adapter );
+
+      // Early stop was requested
+      bool stop_get(
+            void ) const;
+
+      // Closes the file of the heartbeat
+      void close(
+            void );
+
+   private:
+      // Process declarations
+      void beat_thrd(
+            void );
+
+      // Resident memory of the process, 0: unknown
+      static std::uint64_t rss_get(
+            void );
+
+      bool                           beat_en = false;
+      bool                           beat_stop = false;
+      std::string                    file_name;       // Empty: heartbeat is reported to the console
+      sc_core::sc_time               beat_period;
+      double                         rate_min = 0.0;  // Simulated seconds per wall second, 0: no check
+      sc_core::sc_time               stall_time;      // Zero: no check
+      std::ofstream                  beat_str;        // One JSON object per line
+      std::vector<cosim_adapter_c*>  adpt_list;
+   };
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_BEAT_H_ */
@@ -0,0 +1,78 @@
+/*
+ * cosim_bench.h
+ *
+ *  Description:
+ *    Synthetic scalable workload. Preferences are generated from the benchmark
+ *    specification for each point of the grid of the workload parameters (number
+ *    of SIMD cores, blocks per core, threads, clique width, config length, tasks
+ *    per thread). The points are simulated one at a time by worker processes and
+ *    the wall-clock time, simulated seconds per second and peak RSS of each run
+ *    are gathered into one results file and compared with the baseline
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_BENCH_H_
+#define COSIM_COMMON_INCLUDE_COSIM_BENCH_H_
+
+#include <string>
+#include <vector>
+#include <boost/property_tree/ptree.hpp>
+#include <systemc>
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_bench_c {
+   public:
+      // Runs the benchmark. Returns false in the parent process when all the points are done.
+      // Returns true in the worker process with its preferences set in cosim_pref and
+      // saved to pref_file
+      bool run(
+            const std::string&                   spec_file,
+            std::string&                         pref_file );
+
+      bool enabled(
+            void ) const;
+
+      // Parent: exit status of the benchmark. Non-zero if a run failed or regressed
+      int status(
+            void ) const;
+
+      // Worker: writes summary of the simulation to its directory
+      void summary(
+            void );
+
+      // Generates preferences of the point from the base preferences and templates
+      static void pref_gen(
+            const boost_pt::ptree&               spec_pt,
+            const boost_pt::ptree&               parm_pt,    // Workload parameters of the point
+            boost_pt::ptree&                     pref_pt );  // In: base, out: generated
+
+   private:
+      class point_data_t {
+      public:
+         std::string                           name;
+         boost_pt::ptree                       parm_pt;    // parameter -> value
+         int                                   status   = -1;
+         double                                wall_sec = 0.0;
+         long                                  rss_kb   = 0;
+      };
+
+      void point_add(
+            const boost_pt::ptree&               spec_pt );
+
+      void base_check(
+            const std::string&                   base_file,
+            boost_pt::ptree&                     res_pt );
+
+      bool        work_en  = false;
+      std::size_t fail_num = 0;
+      std::size_t regr_num = 0;
+      std::vector<point_data_t> point_list;
+   };
+
+   extern cosim_bench_c cosim_bench;
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_BENCH_H_ */
@@ -0,0 +1,95 @@
+/*
+ * cosim_ckpt.h
+ *
+ *  Description:
+ *    Checkpoint and restore of the simulation. At the checkpoint time the
+ *    process is forked into a snapshot server which keeps the complete state of
+ *    the simulation (planner, adapters, channels, SIMD cores, dump buffers).
+ *    The server listens on a unix socket. Each restore request forks the
+ *    snapshot again, and the copy continues the simulation from the checkpoint
+ *    with the console and the working directory of the requesting process.
+ *    Output files which are open at the checkpoint are copied by the server and
+ *    each restored copy continues its own files in the working directory of the
+ *    requesting process. The snapshot exists only while the server runs
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_CKPT_H_
+#define COSIM_COMMON_INCLUDE_COSIM_CKPT_H_
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+#include <systemc>
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_ckpt_c {
+   public:
+      // Init/config declaration
+      void init(
+            boost::optional<const boost_pt::ptree&> cosim_pref_p );  // Co-simulation preferences
+
+      bool enabled(
+            void ) const;
+
+      const sc_core::sc_time& time_get(
+            void ) const;
+
+      // Creates the snapshot server. Returns in the running process and in each restored copy
+      void save(
+            void );
+
+      // Client side. Returns exit status of the restored simulation
+      static int restore(
+            const std::string&                   sock_name );
+
+      static int stop(
+            const std::string&                   sock_name );
+
+   private:
+      void serve(
+            void );
+
+      static int connect_sock(
+            const std::string&                   sock_name );
+
+      // Copies the contents of the file from the beginning. Returns false on error
+      static bool file_copy(
+            int                                  src_fd,
+            int                                  dst_fd );
+
+      // Server: copies the output files which are open at the checkpoint
+      void out_save(
+            void );
+
+      // Restored copy: replaces the output files with the copies in the current directory
+      void out_restore(
+            void );
+
+      class out_data_t {
+      public:
+         int                fd      = -1;  // Descriptor of the output file in the simulation
+         int                copy_fd = -1;  // Contents of the file at the checkpoint
+         off_t              pos     = 0;   // File position at the checkpoint
+         int                flags   = 0;   // O_APPEND of the file
+         std::string        name;          // Relative to the working directory of the simulation
+      };
+
+      static const char cmd_restore = 'r';
+      static const char cmd_stop    = 'q';
+
+      bool                    ckpt_en = false;
+      sc_core::sc_time        ckpt_time;
+      std::string             sock_name;
+      std::vector<out_data_t> out_list;  // Output files open at the checkpoint
+   };
+
+   extern cosim_ckpt_c cosim_ckpt;
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_CKPT_H_ */
@@ -0,0 +1,53 @@
+/*
+ * cosim_conv.h
+ *
+ *  Description:
+ *    Conversion routines for co-simulation
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_CONV_H_
+#define COSIM_COMMON_INCLUDE_COSIM_CONV_H_
+
+#include <string>
+#include <cstdint>
+#include <boost/property_tree/ptree.hpp>
+#include <systemc>
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+   // Time from the string with units: "10.0ns", "1us", "0"
+   sc_core::sc_time str2time(
+         const std::string& str );
+
+   // Time from the number of the time resolution units and back
+   sc_core::sc_time val2time(
+         std::uint64_t      val );
+
+   std::uint64_t time2val(
+         const sc_core::sc_time& time );
+
+   // Compact binary representation of the ptree. Appends to bin
+   std::string& pt2bin(
+         const boost_pt::ptree& pt,
+         std::string&           bin );
+
+   // Restores ptree from the binary representation. Advances pos, returns false if the data is incomplete
+   bool bin2pt(
+         const char*&           pos,
+         const char*            end,
+         boost_pt::ptree&       pt );
+
+   // Unsigned LEB128
+   void uint2bin(
+         std::uint64_t          val,
+         std::string&           bin );
+
+   bool bin2uint(
+         const char*&           pos,
+         const char*            end,
+         std::uint64_t&         val );
+} // namespace schd
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_CONV_H_ */
@@ -0,0 +1,72 @@
+/*
+ * cosim_domain.h
+ *
+ *  Description:
+ *    Declaration of the system component:
+ *       Core->planner mux of a planner domain. The cores are grouped into
+ *       domains, each with its own planner. The mux forwards the completions
+ *       of the cores of its domain to the planner of the domain and copies
+ *       the completions imported by the other domains to their muxes
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_DOMAIN_H_
+#define COSIM_COMMON_INCLUDE_COSIM_DOMAIN_H_
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/regex.hpp>
+#include <systemc>
+#include "schd_sig_ptree.h"
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   SC_MODULE( cosim_domain_c ) { // declare module class
+
+   public:
+      sc_core::sc_vector<sc_core::sc_port<sc_core::sc_fifo_in_if< schd::schd_sig_ptree_c>>> vi;     // Completions from the cores of the domain
+      sc_core::sc_port<sc_core::sc_fifo_out_if<schd::schd_sig_ptree_c>>                     plan_o; // Planner of the domain
+      sc_core::sc_vector<sc_core::sc_port<sc_core::sc_fifo_out_if<schd::schd_sig_ptree_c>>> fwd_o;  // Muxes of the other domains
+
+      // Completions forwarded from the other domains
+      sc_core::sc_export<sc_core::sc_fifo_out_if<schd::schd_sig_ptree_c>> fwd_eo;
+
+      // Constructor declaration
+      SC_CTOR( cosim_domain_c );
+
+      // Init/config declaration. Import masks of the other domains in the order of fwd_o, empty: no import
+      void init(
+            std::size_t                          core_num,
+            const std::vector<std::string>&      fwd_mask_list );
+
+   private:
+      // Process declarations
+      void dom_thrd(
+            void );
+
+      // Indexes of the domains which import the completions of the executor
+      const std::vector<std::size_t>& fwd_find(
+            const std::string& src );
+
+      class fwd_data_t {
+      public:
+         bool                                     mask_en = false;
+         boost::regex                             mask;
+         std::deque<schd::schd_sig_ptree_c>       stage;    // Waiting for space in the mux of the domain
+      };
+
+      std::vector<fwd_data_t> fwd_list;
+      std::unordered_map<std::string, std::vector<std::size_t>> fwd_idx_list; // by executor name
+
+      sc_core::sc_fifo<schd::schd_sig_ptree_c> chn_fwd;
+
+      static const int chn_fwd_size = 64;
+   };
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_DOMAIN_H_ */
@@ -0,0 +1,106 @@
+/*
+ * cosim_msg.h
+ *
+ *  Description:
+ *    Messages on the planner side of the adapter. A message is a reference-counted
+ *    handle to an immutable packet. Copies of the handle share the packet, so the
+ *    latency stages, the partition transport and the config words streamed to the
+ *    SIMD core refer to the packet read from the fifo instead of copying the ptree.
+ *    Packets are kept in a pool and recycled when the last handle is released
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_MSG_H_
+#define COSIM_COMMON_INCLUDE_COSIM_MSG_H_
+
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <boost/property_tree/ptree.hpp>
+#include <systemc>
+#include "schd_sig_ptree.h"
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_msg_c {
+   public:
+      cosim_msg_c(
+            void ) = default;
+
+      cosim_msg_c(
+            const cosim_msg_c&                   msg );
+
+      cosim_msg_c(
+            cosim_msg_c&&                        msg );
+
+      ~cosim_msg_c(
+            void );
+
+      cosim_msg_c& operator=(
+            cosim_msg_c                          msg );
+
+      // Packet as it is written to the fifo
+      const schd_sig_ptree_c& sig(
+            void ) const;
+
+      const boost_pt::ptree& get(
+            void ) const;
+
+      bool empty(
+            void ) const;
+
+      // Releases the packet. The handle becomes empty
+      void reset(
+            void );
+
+   private:
+      friend class cosim_msg_pool_c;
+
+      static const std::size_t slot_none = static_cast<std::size_t>( -1 );
+
+      std::size_t slot_idx = slot_none;
+   };
+
+   class cosim_msg_pool_c {
+   public:
+      // New message with the packet read from the fifo (blocking)
+      cosim_msg_c read(
+            sc_core::sc_fifo_in_if<schd_sig_ptree_c>& fifo );
+
+      // New message with a copy of the ptree
+      cosim_msg_c make(
+            const boost_pt::ptree&               pt );
+
+      boost_pt::ptree& stat_get(
+            boost_pt::ptree&                     stat_pt ) const;
+
+   private:
+      friend class cosim_msg_c;
+
+      class slot_data_t {
+      public:
+         schd_sig_ptree_c                        sig;
+         std::size_t                             ref_count = 0;
+      };
+
+      std::size_t alloc(
+            void );
+
+      void retain(
+            std::size_t                          slot_idx );
+
+      void release(
+            std::size_t                          slot_idx );
+
+      std::deque<slot_data_t>  slot_list;  // Stable addresses. Slots are not removed
+      std::vector<std::size_t> slot_free;  // Free slots
+      std::size_t              slot_peak  = 0;  // Peak number of the slots in use
+      std::uint64_t            msg_count  = 0;  // Messages created
+   };
+
+   extern cosim_msg_pool_c cosim_msg_pool;
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_MSG_H_ */
@@ -0,0 +1,84 @@
+/*
+ * cosim_part.h
+ *
+ *  Description:
+ *    Partitioned simulation of the SIMD cores. Each SIMD core with its
+ *    adapter back-end runs in a separate process with its own SystemC kernel.
+ *    Planner and adapter front-ends run in the parent process. The processes
+ *    are synchronized conservatively at the adapter latency stages: lookahead
+ *    is the minimum latency of the adapters
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_PART_H_
+#define COSIM_COMMON_INCLUDE_COSIM_PART_H_
+
+#include <string>
+#include <vector>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+#include <systemc>
+#include "cosim_adapter.h"
+#include "cosim_beat.h"
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_part_c {
+   public:
+      // Init/config declaration
+      void init(
+            boost::optional<const boost_pt::ptree&> cosim_pref_p,    // Co-simulation preferences
+            boost::optional<const boost_pt::ptree&> simd_pref_p );   // SIMD core preferences
+
+      bool enabled(
+            void ) const;
+
+      // Creates the process for each SIMD core. Returns 0 in the parent process and index of
+      // the core (same as in core_list) in the child process. The child process changes its
+      // working directory to the one named after the core
+      std::size_t fork_cores(
+            void );
+
+      // Parent: adapter front-end for each core in the order of the cores
+      // Child:  adapter back-end of the core
+      void add_adapter(
+            cosim_adapter_c& adapter );
+
+      // Runs the simulation in windows of lookahead length. Early stop of the heartbeat
+      // of any process ends the simulation of all of them at the same window
+      void run(
+            const sc_core::sc_time& end_time,
+            const cosim_beat_c&     beat );
+
+   private:
+      class peer_data_t {
+      public:
+         std::string                           name;
+         int                                   pid    = -1;
+         int                                   fd_rd  = -1;
+         int                                   fd_wr  = -1;
+         cosim_adapter_c*                      adapter_p = nullptr;
+      };
+
+      void msg_write(
+            int                                   fd,
+            bool                                  stop,
+            const cosim_adapter_c::dly_list_t&    dly_list );
+
+      void msg_read(
+            int                                   fd,
+            bool&                                 stop,
+            cosim_adapter_c::dly_list_t&          dly_list );
+
+      bool               part_en  = false;
+      std::size_t        part_idx = 0;             // 0: parent process
+      std::vector<peer_data_t> peer_list;          // Parent: all cores. Child: the parent only
+      std::size_t        adpt_idx = 0;
+   };
+
+   extern cosim_part_c cosim_part;
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_PART_H_ */
@@ -0,0 +1,57 @@
+/*
+ * cosim_pref.h
+ *
+ *  Description:
+ *    Preferences of the co-simulation with the binary cache. Parsed JSON
+ *    preferences are saved next to the preferences file in the compact binary
+ *    format together with the hash of the file. Later runs with the same file
+ *    map the cache into memory instead of parsing JSON. Executors with "replicate"
+ *    are expanded into the copies for the replicated SIMD cores
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_PREF_H_
+#define COSIM_COMMON_INCLUDE_COSIM_PREF_H_
+
+#include <string>
+#include <cstdint>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_pref_c {
+   public:
+      void load(
+            const std::string&                   file_name );
+
+      // Preferences which are already parsed
+      void set(
+            const boost_pt::ptree&               pref_pt );
+
+      boost::optional<const boost_pt::ptree&> get_pref(
+            const std::string&                   pref_name ) const;
+
+   private:
+      bool cache_read(
+            const std::string&                   cache_name,
+            std::uint64_t                        file_hash );
+
+      void cache_write(
+            const std::string&                   cache_name,
+            std::uint64_t                        file_hash );
+
+      static void exec_expand(
+            boost_pt::ptree&                     pref_pt );
+
+      static const std::string cache_magic;  // Changes with the layout of the cached tree
+
+      boost_pt::ptree    pref_pt;
+   };
+
+   extern cosim_pref_c cosim_pref;
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_PREF_H_ */
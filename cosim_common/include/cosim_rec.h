@@ -0,0 +1,161 @@
+/*
+ * cosim_rec.h
+ *
+ *  Description:
+ *    Record and replay of the traffic on the adapter boundary.
+ *    The adapters record the config words written to the SIMD cores, the event
+ *    packets received from the cores and the dispatch and completion of each job.
+ *    Replay of the SIMD side drives the cores with the recorded config words
+ *    without the planner and the adapters. The scalar processor dummy of each
+ *    core is the driver. Replay of the planner side completes each job after the
+ *    recorded latency of its executor without the SIMD cores.
+ *    File layout:
+ *       header : "COSIMRC1", time resolution in seconds (double)
+ *       records: type, then
+ *                'N': length and characters of the name. Names are indexed in the order of the records
+ *                'W': core name index, time, ptree of the config word written to busw_o
+ *                'E': core name index, time, ptree of the packet read from event_i
+ *                'D': executor name index, time of the job dispatch
+ *                'C': executor name index, time of the job completion
+ *    Numbers are unsigned LEB128, time is in the time resolution units. Ptree
+ *    uses the binary representation of cosim_conv.h
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_REC_H_
+#define COSIM_COMMON_INCLUDE_COSIM_REC_H_
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <cstdint>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+#include <systemc>
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_rec_c {
+   public:
+      ~cosim_rec_c(
+            void );
+
+      // Init/config declaration. Opens the recording or loads the replay
+      void init(
+            boost::optional<const boost_pt::ptree&> cosim_pref_p );  // Co-simulation preferences
+
+      enum rply_mode_t {
+         RPLY_NONE,  // No replay
+         RPLY_SIMD,  // SIMD cores are driven from the recording, no planner and adapters
+         RPLY_PLAN   // Planner with the adapters, jobs are completed after the recorded latency
+      };
+
+      bool enabled(                                             // Recording is enabled
+            void ) const;
+
+      rply_mode_t rply_get(
+            void ) const;
+
+      // Recording. Returns rec_none if the recording is disabled
+      std::size_t name_add(
+            const std::string&                   name );
+
+      void busw(
+            std::size_t                          core_idx,
+            const sc_core::sc_time&              time,
+            const boost_pt::ptree&               pt );
+
+      void evnt(
+            std::size_t                          core_idx,
+            const sc_core::sc_time&              time,
+            const boost_pt::ptree&               pt );
+
+      void disp(
+            std::size_t                          exec_idx,
+            const sc_core::sc_time&              time );
+
+      void done(
+            std::size_t                          exec_idx,
+            const sc_core::sc_time&              time );
+
+      // Writes the rest of the records and closes the file
+      void close(
+            void );
+
+      static const std::size_t rec_none = static_cast<std::size_t>( -1 );
+
+      // Replay of the SIMD side
+      class word_data_t {
+      public:
+         sc_core::sc_time                      time;
+         boost_pt::ptree                       pt;
+      };
+
+      typedef std::deque<word_data_t> word_list_t;
+
+      // Config words of the core in the order of the recording. The driver takes them from the list
+      word_list_t& word_list_get(
+            const std::string&                   core_name );
+
+      // Number of the recorded events of the core
+      std::size_t evnt_num_get(
+            const std::string&                   core_name ) const;
+
+      // The driver has written all the words and received all the events. Stops the simulation after the last core
+      void core_done(
+            const std::string&                   core_name,
+            std::size_t                          evnt_num );
+
+      // Replay of the planner side. Latency of the next job of the executor
+      sc_core::sc_time lat_next(
+            const std::string&                   exec_name );
+
+   private:
+      class core_data_t {
+      public:
+         word_list_t                           word_list;
+         std::size_t                           evnt_num = 0;
+      };
+
+      class exec_data_t {
+      public:
+         std::deque<sc_core::sc_time>          lat_list;
+         sc_core::sc_time                      disp_time;  // Last dispatch in the recording
+         sc_core::sc_time                      lat_last;   // Used when the recorded jobs are exhausted
+         bool                                  lat_en = false;
+      };
+
+      void load(
+            const std::string&                   rply_file );
+
+      void rec_head(
+            char                                 type,
+            std::size_t                          name_idx,
+            const sc_core::sc_time&              time );
+
+      void rec_flush(
+            bool                                 force );
+
+      bool               rec_en    = false;
+      rply_mode_t        rply_mode = RPLY_NONE;
+      std::string        file_name;
+      std::string        rec_data;    // Records to be written
+      std::ofstream      file_str;
+      std::size_t        name_num  = 0;
+
+      static const std::size_t rec_flush_size = 65536;
+
+      std::unordered_map<std::string, core_data_t> core_list;
+      std::unordered_map<std::string, exec_data_t> exec_list;
+      std::size_t        core_word_num = 0;  // Cores with the recorded config words
+      std::size_t        core_done_num = 0;
+   };
+
+   extern cosim_rec_c cosim_rec;
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_REC_H_ */
@@ -0,0 +1,74 @@
+/*
+ * cosim_router.h
+ *
+ *  Description:
+ *    Declaration of the system component:
+ *       Planner->core router for co-simulation. Plain prefix masks are
+ *       resolved with a trie, other masks fall back to regex
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_ROUTER_H_
+#define COSIM_COMMON_INCLUDE_COSIM_ROUTER_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/regex.hpp>
+#include <systemc>
+#include "schd_sig_ptree.h"
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   SC_MODULE( cosim_router_c ) { // declare module class
+
+   public:
+      // Same ports as schd_ptree_xbar_c
+      sc_core::sc_vector<sc_core::sc_port<sc_core::sc_fifo_in_if< schd::schd_sig_ptree_c>>> vi;
+      sc_core::sc_vector<sc_core::sc_port<sc_core::sc_fifo_out_if<schd::schd_sig_ptree_c>>> vo;
+
+      // Constructor declaration
+      SC_CTOR( cosim_router_c );
+
+      // Init/config declaration. Preferences have the same format as for schd_ptree_xbar_c
+      void init(
+            boost::optional<const boost_pt::ptree&> pref_p );
+
+      // Resolve index of the output port for the destination name
+      std::size_t route(
+            const std::string& dst ) const;
+
+   private:
+      // Process declarations
+      void rout_thrd(
+            void );
+
+      static const std::size_t dst_none = static_cast<std::size_t>( -1 );
+
+      // Returns true if the mask is ^<literal>.*$ and extracts the literal
+      static bool mask_prefix(
+            const std::string& mask,
+            std::string&       prefix );
+
+      class trie_node_t {
+      public:
+         std::size_t                                dst_idx = dst_none; // Lowest index of the prefix mask which ends here
+         std::vector<std::pair<char, std::size_t>> next_list;            // Child nodes
+      };
+
+      class rgxp_data_t {
+      public:
+         std::size_t                                dst_idx = dst_none;
+         boost::regex                               rgxp;
+      };
+
+      std::vector<trie_node_t> trie_list;   // trie_list[0] is the root
+      std::vector<rgxp_data_t> rgxp_list;   // Complex masks in the order of dst_list
+   };
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_ROUTER_H_ */
@@ -0,0 +1,81 @@
+/*
+ * cosim_stat.h
+ *
+ *  Description:
+ *    Declaration of the system component:
+ *       Statistics of the co-simulation. Collects the counters of the adapters,
+ *       samples them periodically and writes the report at the end of the run
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_STAT_H_
+#define COSIM_COMMON_INCLUDE_COSIM_STAT_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+#include <systemc>
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_adapter_c;
+
+   // Histogram with power of 2 buckets: 0, 1, 2-3, 4-7, ...
+   class cosim_hist_c {
+   public:
+      void add(
+            std::uint64_t                        value );
+
+      boost_pt::ptree& get(
+            boost_pt::ptree&                     hist_pt ) const;
+
+   private:
+      std::vector<std::uint64_t>                 bin_list;
+   };
+
+   SC_MODULE( cosim_stat_c ) { // declare module class
+
+   public:
+      // Constructor declaration
+      SC_CTOR( cosim_stat_c );
+
+      // Init/config declaration
+      void init(
+            boost::optional<const boost_pt::ptree&> cosim_pref_p );  // Co-simulation preferences
+
+      bool enabled(
+            void ) const;
+
+      void add_adapter(
+            cosim_adapter_c&                     adapter );
+
+      // Writes the report of all the adapters
+      void dump(
+            void );
+
+      // Writes the buffered samples into the file
+      void flush(
+            void );
+
+   private:
+      // Process declarations
+      void smpl_thrd(
+            void );
+
+      boost_pt::ptree& stat_get(
+            boost_pt::ptree&                     stat_pt );
+
+      bool                           stat_en = false;
+      std::string                    file_name;
+      sc_core::sc_time               smpl_period;     // Zero: no sampling
+      std::ofstream                  smpl_str;        // Samples, one JSON object per line
+      std::vector<cosim_adapter_c*>  adpt_list;
+   };
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_STAT_H_ */
@@ -0,0 +1,118 @@
+/*
+ * cosim_stream.h
+ *
+ *  Description:
+ *    Streaming dump of the co-simulation packets. Packets are serialized into
+ *    compact binary records on the simulation thread and passed through the
+ *    bounded lock-free queue to the writer thread. The stream is converted to
+ *    the .mat files of schd_dump by replaying it through schd_dump_buf_c
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_STREAM_H_
+#define COSIM_COMMON_INCLUDE_COSIM_STREAM_H_
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <fstream>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/regex.hpp>
+#include <systemc>
+#include "schd_dump.h"
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_stream_c {
+   public:
+      ~cosim_stream_c(
+            void );
+
+      // Init/config declaration
+      void init(
+            boost::optional<const boost_pt::ptree&> cosim_pref_p );  // Co-simulation preferences
+
+      bool enabled(
+            void ) const;
+
+      // Registers the dump channel. Returns chan_none if the channel is not streamed
+      std::size_t chan_add(
+            const std::string&                   chan_name );
+
+      // Records the packet with the current simulation time
+      void write(
+            std::size_t                          chan_idx,
+            const boost_pt::ptree&               pt );
+
+      // Flushes the queue and closes the file
+      void close(
+            void );
+
+      static const std::size_t chan_none = static_cast<std::size_t>( -1 );
+
+      static const std::string stream_magic;
+      static const char        rec_chan = 'C';   // Channel: index, name
+      static const char        rec_pckt = 'P';   // Packet: channel index, time, ptree
+
+   private:
+      void push(
+            void );
+
+      void writ_thrd(
+            void );
+
+      bool                     strm_en  = false;
+      std::string              file_name;
+      boost::regex             chan_mask;
+      std::size_t              chan_num = 0;
+
+      // Single producer (simulation), single consumer (writer thread)
+      std::vector<std::string> slot_list;
+      std::atomic<std::size_t> slot_head{ 0 };   // Written by the producer
+      std::atomic<std::size_t> slot_tail{ 0 };   // Written by the consumer
+      std::atomic<bool>        writ_stop{ false };
+      std::thread              writ_thread;
+      std::ofstream            file_str;
+
+      std::string              rec_buf;          // Record under construction
+      std::size_t              full_num = 0;     // Number of times the producer waited for the writer
+   };
+
+   extern cosim_stream_c cosim_stream;
+
+   // Dump buffer of the adapter: schd_dump_buf_c or the stream
+   class cosim_dump_c {
+   public:
+      cosim_dump_c(
+            const std::string&                   chan_name );
+
+      void write(
+            const boost_pt::ptree&               pt );
+
+   private:
+      std::size_t                                        chan_idx = cosim_stream_c::chan_none;
+      std::unique_ptr<schd_dump_buf_c<boost_pt::ptree>>  buf_p;
+   };
+
+   SC_MODULE( cosim_stream_play_c ) { // Replays the stream through schd_dump_buf_c
+
+   public:
+      SC_CTOR( cosim_stream_play_c );
+
+      void init(
+            const std::string&                   file_name );
+
+   private:
+      void play_thrd(
+            void );
+
+      std::string                                        strm_data;
+   };
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_STREAM_H_ */
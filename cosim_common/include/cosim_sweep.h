@@ -0,0 +1,92 @@
+/*
+ * cosim_sweep.h
+ *
+ *  Description:
+ *    Parameter sweep runner. The base preferences file is parsed once, each
+ *    scenario of the sweep specification overrides some of the preferences and
+ *    is simulated in a worker process in its own directory. Summaries of the
+ *    runs are gathered into one results file
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_SWEEP_H_
+#define COSIM_COMMON_INCLUDE_COSIM_SWEEP_H_
+
+#include <string>
+#include <vector>
+#include <boost/property_tree/ptree.hpp>
+#include <systemc>
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_sweep_c {
+   public:
+      // Runs the sweep. Returns false in the parent process when all the scenarios are done.
+      // Returns true in the worker process with its preferences set in cosim_pref and
+      // saved to pref_file
+      bool run(
+            const std::string&                   base_file,
+            const std::string&                   sweep_file,
+            std::string&                         pref_file );
+
+      bool enabled(
+            void ) const;
+
+      // Worker: writes summary of the simulation to its directory
+      void summary(
+            void );
+
+      // Node of the preferences tree. Path is separated with '.'. Each segment is either
+      // a key or the "name" of the element of the list. Unmatched segment is an error
+      static boost_pt::ptree& pref_find(
+            boost_pt::ptree&                     pref_pt,
+            const std::string&                   path );
+
+      // Sets the value in the preferences tree
+      static void pref_put(
+            boost_pt::ptree&                     pref_pt,
+            const std::string&                   path,
+            const std::string&                   value );
+
+      // Writes summary of the simulation to summ_name in the current directory
+      static void summ_write(
+            void );
+
+      // Forks the worker of the run. Returns pid of the worker in the parent and 0 in the
+      // worker, which runs in dir_name with its console output in log_name
+      static int work_fork(
+            const std::string&                   dir_name );
+
+      // Worker: saves the preferences of the run to pref_name and passes them to the simulation
+      static void work_pref(
+            const boost_pt::ptree&               pref_pt,
+            std::string&                         pref_file );
+
+      static const std::string summ_name;
+
+   private:
+      class scen_data_t {
+      public:
+         std::string                           name;
+         boost_pt::ptree                       set_pt;     // path -> value
+         int                                   pid    = -1;
+         int                                   status = -1;
+         double                                wall_sec = 0.0;
+      };
+
+      void scen_add(
+            const boost_pt::ptree&               sweep_pt );
+
+      bool        work_en = false;
+      std::vector<scen_data_t> scen_list;
+
+      static const std::string pref_name;
+      static const std::string log_name;
+   };
+
+   extern cosim_sweep_c cosim_sweep;
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_SWEEP_H_ */
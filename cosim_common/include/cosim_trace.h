@@ -0,0 +1,127 @@
+/*
+ * cosim_trace.h
+ *
+ *  Description:
+ *    Compact binary trace of the co-simulation signals.
+ *    File layout:
+ *       header : "COSIMTR1", time resolution in seconds (double)
+ *       chunks : 'K', chunk length, start time, record count, records
+ *                record: time delta from the previous record in the chunk,
+ *                signal index, value xor previous value of the signal in the chunk
+ *       index  : 'I', signal count, signal names, chunk count, start time and file offset of each chunk
+ *       footer : file offset of the index (8 bytes)
+ *    Numbers are unsigned LEB128 unless stated otherwise. Each chunk is decoded on
+ *    its own, so the trace can be read from any chunk found through the index.
+ *    Chunks are written to the file by the background thread
+ */
+
+#ifndef COSIM_COMMON_INCLUDE_COSIM_TRACE_H_
+#define COSIM_COMMON_INCLUDE_COSIM_TRACE_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <cstdint>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/regex.hpp>
+#include <systemc>
+
+// Short alias for the namespace
+namespace boost_pt = boost::property_tree;
+
+namespace schd {
+
+   class cosim_trace_c {
+   public:
+      ~cosim_trace_c(
+            void );
+
+      // Init/config declaration
+      void init(
+            boost::optional<const boost_pt::ptree&> trace_pref_p );  // Trace preferences
+
+      bool enabled(
+            void ) const;
+
+      // Registers the signal. Returns sig_none if the signal is filtered out
+      std::size_t sig_add(
+            const std::string&                   sig_name );
+
+      // Records the new value of the signal at the current simulation time
+      void change(
+            std::size_t                          sig_idx,
+            std::uint64_t                        value );
+
+      // Writes the last chunk and the index and closes the file
+      void close(
+            void );
+
+      static const std::size_t sig_none = static_cast<std::size_t>( -1 );
+
+   private:
+      class wndw_data_t {
+      public:
+         sc_core::sc_time                      start;
+         sc_core::sc_time                      stop;
+      };
+
+      bool wndw_check(
+            const sc_core::sc_time&              time );
+
+      void chunk_start(
+            const sc_core::sc_time&              time );
+
+      void chunk_push(
+            void );
+
+      void file_push(
+            std::string&                         data );
+
+      void rec_add(
+            std::size_t                          sig_idx,
+            std::uint64_t                        time_val );
+
+      void writ_thrd(
+            void );
+
+      bool                       trce_en  = false;
+      std::string                file_name;
+      boost::regex               sig_mask;
+      std::vector<wndw_data_t>   wndw_list;    // Sorted, empty: whole simulation
+      std::size_t                wndw_idx = 0; // Current or next window
+      std::size_t                wndw_last = sig_none; // Window of the last chunk
+
+      std::vector<std::string>   sig_name_list;
+      std::vector<std::uint64_t> sig_val_list;   // Current values
+      std::vector<std::uint64_t> sig_prev_list;  // Last values written to the current chunk
+
+      std::size_t                chunk_size = 65536;
+      bool                       chunk_open = false;
+      std::string                chunk_data;     // Records of the current chunk
+      std::uint64_t              chunk_start_val = 0;
+      std::uint64_t              chunk_last_val  = 0;
+      std::uint64_t              chunk_rec_num   = 0;
+      typedef std::vector<std::pair<std::uint64_t, std::uint64_t>> chunk_list_t;
+
+      chunk_list_t               chunk_list;     // Start time, file offset
+      std::uint64_t              file_pos = 0;
+
+      // Chunks for the writer thread
+      static const std::size_t   chunk_pend_max = 16;
+      std::deque<std::string>    chunk_pend_list;
+      std::mutex                 chunk_mtx;
+      std::condition_variable    chunk_cv;
+      bool                       writ_stop = false;
+      std::thread                writ_thread;
+      std::ofstream              file_str;
+   };
+
+   extern cosim_trace_c cosim_trace;
+}
+
+#endif /* COSIM_COMMON_INCLUDE_COSIM_TRACE_H_ */
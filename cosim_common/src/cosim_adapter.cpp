@@ -6,8 +6,15 @@
 
 #include <iterator>
 #include <algorithm>
+#include <fstream>
 #include <boost/foreach.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/property_tree/json_parser.hpp>
 #include "cosim_adapter.h"
+#include "cosim_conv.h"
+#include "cosim_stream.h"
+#include "cosim_trace.h"
+#include "cosim_rec.h"
 #include "schd_conv_ptree.h"
 #include "schd_dump.h"
 #include "schd_assert.h"
@@ -31,13 +38,23 @@ cosim_adapter_c::cosim_adapter_c(
    , chn_plan_adap( "chn_plan_adap", chn_plan_adap_size ) {
 
    // Process registrations
-   SC_CTHREAD( exec_thrd, clock_i.pos() ); //  Synchronous thread for data processing
+   SC_THREAD( exec_thrd ); //  Synchronous thread for data processing
+   sensitive << clock_i.pos();
+   dont_initialize();
    reset_signal_is( reset_i, true );
+
+   SC_THREAD( plan_thrd ); // Latency stage for the packets from planner
+   SC_THREAD( done_thrd ); // Latency stage for the completions to planner
+
+   SC_METHOD( gate_mthd ); // Gated clock of the SIMD core
+   sensitive << clock_i;
+   dont_initialize();
 } // cosim_adapter_c::cosim_adapter_c(
 
 void cosim_adapter_c::init(
       boost::optional<const boost_pt::ptree&> schd_exec_p,        // SCHD exec preferences
-      boost::optional<const boost_pt::ptree&> simd_core_p ) {     // SIMD core preferences
+      boost::optional<const boost_pt::ptree&> simd_core_p,        // SIMD core preferences
+      boost::optional<const boost_pt::ptree&> adpt_pref_p ) {     // Adapter preferences (optional)
 
    // Extract simd core name from the adapter name
    std::string adpt_name = name();
@@ -49,8 +66,108 @@ void cosim_adapter_c::init(
 
    core_name = adpt_name.substr( 0, core_pos );
 
+   // Adapter preferences. Defaults correspond to one word per clock cycle
+   if( adpt_pref_p.is_initialized() ) {
+      try {
+         conf_burst = std::stoul( adpt_pref_p.get().get<std::string>( "burst", "1" ));
+         evnt_drain = std::stoul( adpt_pref_p.get().get<std::string>( "drain", "1" ));
+         cliq_slots = std::stoul( adpt_pref_p.get().get<std::string>( "cliq_slots", "0" ));
+         plan_dly   = str2time(   adpt_pref_p.get().get<std::string>( "latency",    "0" ));
+         lt_quantum = str2time(   adpt_pref_p.get().get<std::string>( "quantum",    "1us" ));
+         gate_idle  = std::stoul( adpt_pref_p.get().get<std::string>( "gate",       "0" ));
+
+         boost::optional<const boost_pt::ptree&> memo_pref_p = adpt_pref_p.get().get_child_optional( "memo" );
+
+         if( memo_pref_p.is_initialized()) {
+            memo_count = std::stoul( memo_pref_p.get().get<std::string>( "count", "3" ));
+            memo_file  = memo_pref_p.get().get<std::string>( "file", "" );
+         }
+
+         std::string wake_str = adpt_pref_p.get().get<std::string>( "wake", "clock" );
+
+         if( wake_str == "clock" ) {
+            wake_evnt = false;
+         }
+         else if( wake_str == "event" ) {
+            wake_evnt = true;
+         }
+         else {
+            SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect wake mode: " << wake_str;
+         }
+
+         std::string credit_str = adpt_pref_p.get().get<std::string>( "credit", "none" );
+
+         if( credit_str == "none" ) {
+            credit_mode = CREDIT_NONE;
+         }
+         else if( credit_str == "event" ) {
+            credit_mode = CREDIT_EVENT;
+         }
+         else if( credit_str == "status" ) {
+            credit_mode = CREDIT_STATUS;
+         }
+         else {
+            SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect credit mode: " << credit_str;
+         }
+
+         std::string timing_str = adpt_pref_p.get().get<std::string>( "timing", "clock" );
+
+         if( timing_str == "clock" ) {
+            lt_mode = false;
+         }
+         else if( timing_str == "loose" ) {
+            lt_mode = true;
+         }
+         else {
+            SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect timing mode: " << timing_str;
+         }
+      }
+      catch( const boost_pt::ptree_error& err ) {
+         SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << err.what();
+      }
+      catch( const std::exception& err ) {
+         SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect adapter preferences: " << err.what();
+      }
+      catch( ... ) {
+         SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << "Unexpected";
+      }
+   } // if( adpt_pref_p.is_initialized() )
+
+   // Gated clock: the adapter sleeps while the core is idle
+   if( gate_idle != 0 ) {
+      wake_evnt = true;
+   }
+
+   // Cores which share the adapter preferences keep separate caches
+   if( !memo_file.empty()) {
+      if( memo_file.find( "%1%" ) != std::string::npos ) {
+         boost::replace_all( memo_file, "%1%", core_name );
+      }
+      else {
+         memo_file += "." + core_name;
+      }
+   }
+
+   if( memo_count != 0 && !memo_file.empty()) {
+      memo_load();
+   }
+
+   // Record and replay of the adapter boundary
+   core_rec_idx = cosim_rec.name_add( core_name );
+   rply_en      = ( cosim_rec.rply_get() == cosim_rec_c::RPLY_PLAN );
+
+   // Loosely-timed mode hands complete jobs to the core and drains all the packets at each step
+   if( lt_mode ) {
+      if( lt_quantum == sc_core::SC_ZERO_TIME ) {
+         SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect quantum of the loosely-timed mode";
+      }
+
+      conf_burst = 0;
+      evnt_drain = 0;
+   }
+
    // Extract names of the simd core modules from simd core preferences
-   std::list<std::string> dmeu_list; // List of DME/EU blocks in the simd core
+   std::set<std::string> dmeu_list; // Sorted DME/EU blocks in the simd core
 
    BOOST_FOREACH( const boost_pt::ptree::value_type& dmeu_el, simd_core_p.get() ) {
       if( !dmeu_el.first.empty()) {
@@ -58,8 +175,27 @@ void cosim_adapter_c::init(
       }
 
       try {
-         dmeu_list.push_back(
-               core_name + "." + dmeu_el.second.get<std::string>("name"));
+         std::string dmeu_name = core_name + "." + dmeu_el.second.get<std::string>("name");
+
+         dmeu_list.insert( dmeu_name );
+
+         // Blocks with config_slots take part in the credit-based flow control
+         boost::optional<std::string> slot_p = dmeu_el.second.get_optional<std::string>( "param.config_slots" );
+
+         if( credit_mode != CREDIT_NONE && slot_p.is_initialized()) {
+            blck_data_t blck_data;
+
+            blck_data.block  = dmeu_name;
+            blck_data.slots  = std::stoul( slot_p.get());
+            blck_data.credit = blck_data.slots;
+
+            if( blck_data.slots == 0 ) {
+               SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect config slots of: " << dmeu_name;
+            }
+
+            blck_idx_list.insert({ name_hash( 0, dmeu_name ), blck_list.size() });
+            blck_list.push_back( blck_data );
+         }
       }
       catch( const boost_pt::ptree_error& err ) {
          SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << err.what();
@@ -73,7 +209,7 @@ void cosim_adapter_c::init(
    } // BOOST_FOREACH( const boost_pt::ptree::value_type& dmeu_el, simd_core_p.get() )
 
    // Add virtual configuration dmeu
-   dmeu_list.push_back( core_name + ".config" );
+   dmeu_list.insert( core_name + ".config" );
 
    // Extract names of the schd exec blocks which correspond to simd
    BOOST_FOREACH( const boost_pt::ptree::value_type& exec_el, schd_exec_p.get()) {
@@ -87,34 +223,81 @@ void cosim_adapter_c::init(
          SCHD_REPORT_ERROR( "cosim::adapter" ) << name() <<  " Incorrect exec name";
       }
 
-      // Check if the core.dmeu is in the dmeu list
-      if( dmeu_list.end() == std::find_if(
-            dmeu_list.begin(),
-            dmeu_list.end(),
-            [name_p]( const std::string& el )->bool {
-               return el.find( name_p.get() ) == 0; } )) {
+      // Check if the core.dmeu is in the dmeu list. The names which start with the exec
+      // name follow it in the sorted list
+      std::set<std::string>::const_iterator dmeu_it = dmeu_list.lower_bound( name_p.get() );
+
+      bool dmeu_found = ( dmeu_it != dmeu_list.end() &&
+                          dmeu_it->compare( 0, name_p.get().size(), name_p.get() ) == 0 );
+
+      // Executor of the event of the block: core.dmeu.event_id
+      for( std::size_t dot_pos = name_p.get().find( '.' );
+           !dmeu_found && dot_pos != std::string::npos;
+           dot_pos = name_p.get().find( '.', dot_pos + 1 )) {
+         dmeu_found = ( dmeu_list.count( name_p.get().substr( 0, dot_pos )) != 0 );
+      }
+
+      if( !dmeu_found ) {
          continue;
       }
 
-      evnt_data_t evnt_data;
-      std::size_t evnt_hash = 0;
-      boost::hash_combine(
-            evnt_hash,
-            name_p.get() );
+      std::size_t evnt_hash = name_hash( 0, name_p.get() );
 
-      if( evnt_cliq_list.find( evnt_hash ) != evnt_cliq_list.end()) {
+      if( evnt_idx_list.find( evnt_hash ) != evnt_idx_list.end()) {
          SCHD_REPORT_ERROR( "cosim::adapter" )
                << name()
                << " Duplicate hash for: "
                << name_p.get();
       }
 
+      evnt_data_t evnt_data;
       evnt_data.event = name_p.get();
+      evnt_data.conf     = ( name_p.get().find( core_name + ".config" ) == 0 );
+      evnt_data.cliq_idx = cliq_none;
+
+      // Completion packet does not change from job to job
+      boost_pt::ptree dst_list_pt;
+      dst_list_pt.push_back( std::make_pair( "", boost_pt::ptree().put( "", "planner" ) ));
+
+      boost_pt::ptree done_pt;
+      done_pt.put(       "src",  evnt_data.event );  // Name of this executor
+      done_pt.put_child( "dst",  dst_list_pt     );  // Destination: planner
 
-      evnt_cliq_list.insert({ evnt_hash, evnt_data });
+      evnt_data.done_msg = cosim_msg_pool.make( done_pt );
+
+      // Block of the executor: core.dmeu.event_id
+      for( std::size_t dot_pos = name_p.get().find( '.', core_name.size() + 1 );
+           evnt_data.blck_idx == blck_none && dot_pos != std::string::npos;
+           dot_pos = name_p.get().find( '.', dot_pos + 1 )) {
+         evnt_idx_list_t::const_iterator blck_it = blck_idx_list.find(
+               name_hash( 0, name_p.get().substr( 0, dot_pos )));
+
+         if( blck_it != blck_idx_list.end() &&
+             blck_list[blck_it->second].block.compare( 0, std::string::npos, name_p.get(), 0, dot_pos ) == 0 ) {
+            evnt_data.blck_idx = blck_it->second;
+         }
+      }
+      evnt_data.rec_idx  = cosim_rec.name_add( evnt_data.event );
+
+      evnt_idx_list.insert({ evnt_hash, evnt_list.size() });
+      evnt_list.push_back( evnt_data );
    } // BOOST_FOREACH( const boost_pt::ptree::value_type& exec_el, schd_exec_p.get())
 
-   // Connect fifo channels with the corresponding exports
+   // Allocate clique slab. Member lists are allocated by the cliques, so the slab is linear in the executors
+   if( cliq_slots == 0 ) {
+      cliq_slots = evnt_list.size();
+   }
+
+   cliq_pool.resize( cliq_slots );
+   cliq_free.reserve( cliq_slots );
+   cliq_actv.reserve( cliq_slots );
+
+   for( std::size_t cliq_idx = cliq_slots; cliq_idx != 0; cliq_idx -- ) {
+      cliq_free.push_back( cliq_idx - 1 );
+   }
+
+   // Connect fifo channels with the corresponding exports. The router writes packets from planner
+   // into plan_eo and reads completions from plan_ei
    plan_eo.bind( chn_plan_adap );
    plan_ei.bind( chn_adap_plan );
 } // void cosim_adapter_c::init(
@@ -124,157 +307,992 @@ void cosim_adapter_c::add_trace(
       const std::string& top_name ) {
    std::string mod_name = top_name + "." + name() + ".";
 
-   BOOST_FOREACH( evnt_cliq_list_t::value_type& evnt_el, evnt_cliq_list ) {
-      sc_core::sc_trace(
-            tf,
-            &( evnt_el.second.job_hash ),
-            mod_name + evnt_el.second.event + ".job_hash" );
+   BOOST_FOREACH( evnt_list_t::value_type& evnt_el, evnt_list ) {
+      if( cosim_trace.enabled()) { // Binary trace records the changes of job_hash_set()
+         evnt_el.trce_idx = cosim_trace.sig_add(
+               mod_name + evnt_el.event + ".job_hash" );
+      }
+      else {
+         sc_core::sc_trace(
+               tf,
+               &( evnt_el.job_hash ),
+               mod_name + evnt_el.event + ".job_hash" );
+      }
    }
 } // cosim_adapter_c::add_trace(
 
+void cosim_adapter_c::stat_enable(
+      void ) {
+   stat_en = true;
+} // void cosim_adapter_c::stat_enable(
+
+boost_pt::ptree& cosim_adapter_c::stat_get(
+      boost_pt::ptree&                     stat_pt ) const {
+   boost_pt::ptree hist_pt;
+   boost_pt::ptree lat_list_pt;
+
+   stat_pt.clear();
+   stat_pt.put( "name",            name());
+   stat_pt.put( "cycles",          stat_cycle );
+   stat_pt.put( "dispatched",      stat_disp );
+   stat_pt.put( "completed",       stat_done );
+   stat_pt.put( "config_words",    stat_conf );
+   stat_pt.put( "events",          stat_evnt );
+   stat_pt.put( "status",          stat_busr );
+   stat_pt.put( "busw_stall",      stat_busw_stall );
+   stat_pt.put( "done_stall",      stat_done_stall );
+   stat_pt.put( "lt_sync",         stat_lt_sync );
+   stat_pt.put( "credit_wait",     stat_credit_wait );
+   stat_pt.put( "gate_stops",      stat_gate_stop );
+   stat_pt.put( "gate_sec",        stat_gate_time.to_seconds());
+   stat_pt.put( "memo_hits",       stat_memo_hit );
+   stat_pt.put( "memo_misses",     stat_memo_miss );
+   stat_pt.put( "cliq_peak",       cliq_peak );
+
+   stat_pt.add_child( "plan_depth",  hist_plan_depth.get( hist_pt ));
+   stat_pt.add_child( "done_depth",  hist_done_depth.get( hist_pt ));
+   stat_pt.add_child( "evnt_depth",  hist_evnt_depth.get( hist_pt ));
+   stat_pt.add_child( "busr_depth",  hist_busr_depth.get( hist_pt ));
+   stat_pt.add_child( "job_latency", hist_job_lat.get( hist_pt ));
+   stat_pt.add_child( "cliq_latency", hist_cliq_lat.get( hist_pt ));
+
+   BOOST_FOREACH( const lat_list_t::value_type& lat_el, job_lat_list ) {
+      boost_pt::ptree lat_pt;
+
+      lat_pt.put( "job_hash", lat_el.first );
+      lat_pt.put( "count",    lat_el.second.count );
+      lat_pt.put( "mean_sec", lat_el.second.sum.to_seconds() / lat_el.second.count );
+      lat_pt.put( "min_sec",  lat_el.second.min.to_seconds());
+      lat_pt.put( "max_sec",  lat_el.second.max.to_seconds());
+
+      lat_list_pt.push_back( std::make_pair( "", lat_pt ));
+   }
+
+   stat_pt.add_child( "job_list", lat_list_pt );
+
+   return stat_pt;
+} // boost_pt::ptree& cosim_adapter_c::stat_get(
+
+std::size_t cosim_adapter_c::job_actv_get(
+      void ) const {
+   return job_actv;
+} // std::size_t cosim_adapter_c::job_actv_get(
+
+std::uint64_t cosim_adapter_c::job_done_get(
+      void ) const {
+   return job_done;
+} // std::uint64_t cosim_adapter_c::job_done_get(
+
+void cosim_adapter_c::end_of_simulation(
+      void ) {
+   if( part_mode == PART_PLAN ) { // Cliques are tracked in the SIMD core process
+      return;
+   }
+
+   SCHD_REPORT_INFO( "cosim::adapter" ) << name()
+                                        << " Peak outstanding cliques: "
+                                        << cliq_peak
+                                        << " of "
+                                        << cliq_slots;
+
+   if( memo_count != 0 ) {
+      SCHD_REPORT_INFO( "cosim::adapter" ) << name()
+                                           << " Memoized jobs: "
+                                           << stat_memo_hit
+                                           << " of "
+                                           << stat_memo_hit + stat_memo_miss;
+
+      if( !memo_file.empty()) {
+         memo_save();
+      }
+   }
+} // cosim_adapter_c::end_of_simulation(
+
+std::size_t cosim_adapter_c::memo_sig_get(
+      std::size_t            job_hash,
+      const boost_pt::ptree& optn_pt ) {
+   memo_buf.clear();
+
+   std::size_t memo_sig = name_hash( job_hash, pt2bin( optn_pt, memo_buf ));
+
+   return ( memo_sig == 0 ) ? 1 : memo_sig;
+} // std::size_t cosim_adapter_c::memo_sig_get(
+
+void cosim_adapter_c::memo_add(
+      std::size_t             memo_sig,
+      const sc_core::sc_time& lat ) {
+   memo_data_t& memo_data = memo_list[memo_sig];
+
+   if( memo_data.count == 0 || memo_data.lat != lat ) { // Latency is not stable. Start again
+      memo_data.lat   = lat;
+      memo_data.count = 0;
+   }
+
+   memo_data.count ++;
+} // void cosim_adapter_c::memo_add(
+
+void cosim_adapter_c::memo_load(
+      void ) {
+   std::ifstream memo_str( memo_file );
+
+   if( !memo_str.is_open()) { // The cache is created at the end of the run
+      return;
+   }
+
+   boost_pt::ptree memo_pt;
+
+   try {
+      boost_pt::read_json( memo_str, memo_pt );
+
+      if( memo_pt.get<double>( "res_sec" ) != sc_core::sc_get_time_resolution().to_seconds()) {
+         SCHD_REPORT_INFO( "cosim::adapter" ) << name() << " Time resolution of the cache does not match: " << memo_file;
+         return;
+      }
+
+      BOOST_FOREACH( const boost_pt::ptree::value_type& memo_el, memo_pt.get_child( "jobs" )) {
+         memo_data_t& memo_data = memo_list[memo_el.second.get<std::size_t>( "sig" )];
+
+         memo_data.lat   = val2time( memo_el.second.get<std::uint64_t>( "lat" ));
+         memo_data.count = memo_el.second.get<std::size_t>( "count" );
+      }
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " " << memo_file << " " << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect cache: " << memo_file << " " << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << "Unexpected";
+   }
+
+   SCHD_REPORT_INFO( "cosim::adapter" ) << name() << " Cached jobs: " << memo_list.size() << " from " << memo_file;
+} // void cosim_adapter_c::memo_load(
+
+void cosim_adapter_c::memo_save(
+      void ) const {
+   boost_pt::ptree memo_pt;
+   boost_pt::ptree memo_list_pt;
+
+   memo_pt.put( "res_sec", sc_core::sc_get_time_resolution().to_seconds());
+
+   BOOST_FOREACH( const memo_list_t::value_type& memo_el, memo_list ) {
+      boost_pt::ptree memo_el_pt;
+
+      memo_el_pt.put( "sig",   memo_el.first );
+      memo_el_pt.put( "lat",   time2val( memo_el.second.lat ));
+      memo_el_pt.put( "count", memo_el.second.count );
+
+      memo_list_pt.push_back( std::make_pair( "", memo_el_pt ));
+   }
+
+   memo_pt.add_child( "jobs", memo_list_pt );
+
+   try {
+      boost_pt::write_json( memo_file, memo_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " " << err.what();
+   }
+} // void cosim_adapter_c::memo_save(
+
+std::size_t cosim_adapter_c::name_hash(
+      std::size_t        seed,
+      const std::string& str ) {
+   std::size_t hash = ( seed == 0 ) ? 14695981039346656037ULL : seed; // FNV-1a offset basis
+
+   for( const char ch : str ) {
+      hash ^= static_cast<unsigned char>( ch );
+      hash *= 1099511628211ULL;                                        // FNV-1a prime
+   }
+
+   return hash;
+} // cosim_adapter_c::name_hash(
+
+const std::string* cosim_adapter_c::child_data(
+      const boost_pt::ptree& pt,
+      const std::string&     key ) {
+   boost_pt::ptree::const_assoc_iterator child_it = pt.find( key );
+
+   if( child_it == pt.not_found() ) {
+      return nullptr;
+   }
+
+   return &( child_it->second.data() );
+} // cosim_adapter_c::child_data(
+
+std::size_t cosim_adapter_c::evnt_find(
+      std::size_t        evnt_hash ) const {
+   evnt_idx_list_t::const_iterator evnt_idx_it = evnt_idx_list.find( evnt_hash );
+
+   return ( evnt_idx_it == evnt_idx_list.end()) ? evnt_none : evnt_idx_it->second;
+} // cosim_adapter_c::evnt_find(
+
+bool cosim_adapter_c::evnt_match(
+      const std::string& event,
+      const std::string& src,
+      const std::string& evnt_id ) const {
+   // Same as event == core_name + "." + src + "." + evnt_id
+   return event.size() == core_name.size() + src.size() + evnt_id.size() + 2                 &&
+          event.compare( 0,                                     core_name.size(), core_name ) == 0 &&
+          event[core_name.size()] == '.'                                                        &&
+          event.compare( core_name.size() + 1,                  src.size(),       src       ) == 0 &&
+          event[core_name.size() + src.size() + 1] == '.'                                       &&
+          event.compare( core_name.size() + src.size() + 2,     evnt_id.size(),   evnt_id   ) == 0;
+} // cosim_adapter_c::evnt_match(
+
+std::size_t cosim_adapter_c::cliq_get(
+      const std::string& clique ) {
+   std::size_t cliq_hash = name_hash( 0, clique );
+
+   // Outstanding cliques are few, look through the active slots
+   BOOST_FOREACH( std::size_t cliq_idx, cliq_actv ) {
+      if( cliq_pool[cliq_idx].cliq_hash == cliq_hash &&
+          cliq_pool[cliq_idx].clique    == clique ) {
+         return cliq_idx;
+      }
+   }
+
+   if( cliq_free.empty() ) {
+      SCHD_REPORT_ERROR( "cosim::adapter" ) << name()
+                                            << " Clique table is full (cliq_slots: "
+                                            << cliq_slots
+                                            << ") for: "
+                                            << clique;
+   }
+
+   // Take a free slot
+   std::size_t  cliq_idx  = cliq_free.back();
+   cliq_data_t& cliq_data = cliq_pool[cliq_idx];
+
+   cliq_free.pop_back();
+
+   cliq_data.clique.assign( clique );  // Reuses the storage of the previous name
+   cliq_data.cliq_hash  = cliq_hash;
+   cliq_data.actv_pos   = cliq_actv.size();
+   cliq_data.evnt_count = 0;
+   cliq_data.memb_count = 0;
+
+   cliq_actv.push_back( cliq_idx );
+   cliq_peak = std::max( cliq_peak, cliq_actv.size() );
+
+   return cliq_idx;
+} // cosim_adapter_c::cliq_get(
+
+void cosim_adapter_c::cliq_release(
+      std::size_t        cliq_idx ) {
+   std::size_t actv_pos = cliq_pool[cliq_idx].actv_pos;
+
+   // Remove from the active list by moving the last active slot in its place
+   cliq_actv[actv_pos] = cliq_actv.back();
+   cliq_pool[cliq_actv[actv_pos]].actv_pos = actv_pos;
+   cliq_actv.pop_back();
+
+   cliq_free.push_back( cliq_idx );
+} // cosim_adapter_c::cliq_release(
+
+std::size_t cosim_adapter_c::blck_find(
+      const std::string& src ) const {
+   evnt_idx_list_t::const_iterator blck_it = blck_idx_list.find(
+         name_hash( name_hash( name_hash( 0, core_name ), "." ), src ));
+
+   if( blck_it == blck_idx_list.end()) {
+      return blck_none;
+   }
+
+   // Same as block == core_name + "." + src
+   const std::string& block = blck_list[blck_it->second].block;
+
+   return ( block.size() == core_name.size() + src.size() + 1 &&
+            block.compare( core_name.size() + 1, src.size(), src ) == 0 ) ? blck_it->second : blck_none;
+} // std::size_t cosim_adapter_c::blck_find(
+
+void cosim_adapter_c::credit_set(
+      std::size_t        blck_idx,
+      std::size_t        credit ) {
+   blck_data_t& blck_data = blck_list[blck_idx];
+
+   blck_data.credit = std::min( credit, blck_data.slots );
+
+   while( blck_data.credit != 0 && !blck_data.park_list.empty()) {
+      blck_data.credit --;
+
+      if( credit_mode == CREDIT_STATUS ) {
+         blck_data.pend ++;
+      }
+
+      conf_ready.push_back( ready_data_t());
+      conf_ready.back().blck_idx = blck_idx;
+      conf_ready.back().msg      = std::move( blck_data.park_list.front());
+
+      blck_data.park_list.pop_front();
+
+      if( blck_data.park_list.size() == 1 ) { // The planner is read again
+         park_hold --;
+      }
+   }
+} // void cosim_adapter_c::credit_set(
+
+void cosim_adapter_c::pend_retire(
+      void ) {
+   std::uint64_t busw_read = busw_cnt - ( busw_size - busw_o->num_free());
+
+   while( !pend_list.empty() &&
+          pend_list.front().busw_last <= busw_read ) {
+      blck_list[pend_list.front().blck_idx].pend --;
+      pend_list.pop_front();
+   }
+} // void cosim_adapter_c::pend_retire(
+
+void cosim_adapter_c::job_hash_set(
+      evnt_data_t&       evnt_data,
+      std::size_t        job_hash ) {
+   sc_core::sc_time time = time_local();
+
+   if( stat_en ) {
+      if( job_hash != 0 ) { // Dispatch
+         stat_disp ++;
+      }
+      else if( evnt_data.job_hash != 0 ) { // Completion
+         sc_core::sc_time lat_time = time - evnt_data.disp_time;
+         lat_data_t&      lat_data = job_lat_list[evnt_data.job_hash];
+
+         stat_done ++;
+         hist_job_lat.add( time2val( lat_time ));
+
+         lat_data.min = ( lat_data.count == 0 ) ? lat_time : std::min( lat_data.min, lat_time );
+         lat_data.max = ( lat_data.count == 0 ) ? lat_time : std::max( lat_data.max, lat_time );
+         lat_data.sum += lat_time;
+         lat_data.count ++;
+      }
+   } // if( stat_en )
+
+   if( job_hash != 0 ) { // Dispatch
+      job_actv += ( evnt_data.job_hash == 0 ) ? 1 : 0;
+      evnt_data.disp_time = time;
+
+      cosim_rec.disp( evnt_data.rec_idx, time );
+   }
+   else if( evnt_data.job_hash != 0 ) { // Completion
+      job_actv --;
+      job_done ++;
+
+      if( evnt_data.memo_sig != 0 ) { // Job was simulated in detail
+         memo_add( evnt_data.memo_sig, time - evnt_data.disp_time );
+         evnt_data.memo_sig = 0;
+      }
+
+      cosim_rec.done( evnt_data.rec_idx, time );
+   }
+
+   evnt_data.job_hash = job_hash;
+
+   cosim_trace.change( evnt_data.trce_idx, job_hash );
+} // void cosim_adapter_c::job_hash_set(
+
+std::size_t cosim_adapter_c::job_hash_get(
+      const std::string& thrd,
+      const std::string& task,
+      const std::string& prid ) {
+   std::size_t key_hash = name_hash( name_hash( name_hash( 0, thrd ), task ), prid );
+
+   job_hash_list_t::iterator job_it = job_hash_list.find( key_hash );
+
+   if( job_it != job_hash_list.end()  &&
+       job_it->second.thread == thrd &&
+       job_it->second.task   == task &&
+       job_it->second.param  == prid ) {
+      return job_it->second.job_hash;
+   }
+
+   // First occurrence of the job: build the tag and remember its hash
+   job_data_t job_data;
+   job_data.thread = thrd;
+   job_data.task   = task;
+   job_data.param  = prid;
+
+   boost::hash_combine(
+         job_data.job_hash,
+         schd_trace.job_comb( thrd, task, prid ));
+
+   job_hash_list[key_hash] = job_data;
+
+   return job_data.job_hash;
+} // cosim_adapter_c::job_hash_get(
+
+void cosim_adapter_c::part_set(
+      part_mode_t                          mode ) {
+   part_mode = mode;
+} // void cosim_adapter_c::part_set(
+
+const sc_core::sc_time& cosim_adapter_c::latency_get(
+      void ) const {
+   return plan_dly;
+} // cosim_adapter_c::latency_get(
+
+void cosim_adapter_c::part_plan_take(
+      dly_list_t&                          dly_list ) {
+   dly_list.clear();
+   dly_list.swap( plan_dly_list );
+} // void cosim_adapter_c::part_plan_take(
+
+void cosim_adapter_c::part_plan_give(
+      dly_list_t&                          dly_list ) {
+   BOOST_FOREACH( dly_data_t& dly_el, dly_list ) {
+      plan_dly_list.push_back( dly_data_t());
+      plan_dly_list.back().due = dly_el.due;
+      plan_dly_list.back().msg = std::move( dly_el.msg );
+   }
+
+   dly_list.clear();
+   plan_dly_evnt.notify( sc_core::SC_ZERO_TIME );
+} // void cosim_adapter_c::part_plan_give(
+
+void cosim_adapter_c::part_done_take(
+      dly_list_t&                          dly_list ) {
+   dly_list.clear();
+   dly_list.swap( done_dly_list );
+} // void cosim_adapter_c::part_done_take(
+
+void cosim_adapter_c::part_done_give(
+      dly_list_t&                          dly_list ) {
+   BOOST_FOREACH( dly_data_t& dly_el, dly_list ) {
+      done_dly_list.push_back( dly_data_t());
+      done_dly_list.back().due = dly_el.due;
+      done_dly_list.back().msg = std::move( dly_el.msg );
+   }
+
+   dly_list.clear();
+   done_dly_evnt.notify( sc_core::SC_ZERO_TIME );
+} // void cosim_adapter_c::part_done_give(
+
+bool cosim_adapter_c::plan_avail(
+      void ) {
+   if( park_hold != 0 ) { // Back-pressure: a block has more jobs waiting for a free config slot
+      return false;
+   }
+
+   if( plan_dly == sc_core::SC_ZERO_TIME ) {
+      return chn_plan_adap.num_available() != 0;
+   }
+
+   return !plan_dly_list.empty() &&
+          plan_dly_list.front().due <= sc_core::sc_time_stamp();
+} // bool cosim_adapter_c::plan_avail(
+
+void cosim_adapter_c::plan_read(
+      void ) {
+   if( plan_dly == sc_core::SC_ZERO_TIME ) {
+      plan_msg = cosim_msg_pool.read( chn_plan_adap );
+   }
+   else {
+      plan_msg = std::move( plan_dly_list.front().msg );
+      plan_dly_list.pop_front();
+   }
+} // void cosim_adapter_c::plan_read(
+
+void cosim_adapter_c::done_write(
+      const cosim_msg_c& done_msg ) {
+   if( plan_dly == sc_core::SC_ZERO_TIME && !lt_mode ) {
+      // Staged while the planner is not reading. The order of the completions is kept
+      if( !done_stage.empty() ||
+          !chn_adap_plan.nb_write( done_msg.sig() )) { // Write data to the output
+         done_stage.push_back( done_msg );
+      }
+   }
+   else {
+      done_dly_list.push_back( dly_data_t());
+      done_dly_list.back().due = time_local() + plan_dly; // Annotated time in the loosely-timed mode
+      done_dly_list.back().msg = done_msg;
+
+      done_dly_evnt.notify( sc_core::SC_ZERO_TIME );
+   }
+} // void cosim_adapter_c::done_write(
+
+void cosim_adapter_c::done_flush(
+      void ) {
+   while( !done_stage.empty() &&
+          chn_adap_plan.nb_write( done_stage.front().sig() )) { // Write data to the output
+      done_stage.pop_front();
+   }
+
+   if( stat_en && !done_stage.empty() ) {
+      stat_done_stall ++;
+   }
+} // void cosim_adapter_c::done_flush(
+
+void cosim_adapter_c::plan_thrd(
+      void ) {
+   if( plan_dly == sc_core::SC_ZERO_TIME ||
+       part_mode == PART_SIMD ) {
+      return;
+   }
+
+   // Packets from planner are timestamped on arrival
+   for(;;) {
+      while( chn_plan_adap.num_available() != 0 ) {
+         plan_dly_list.push_back( dly_data_t());
+         plan_dly_list.back().due = sc_core::sc_time_stamp() + plan_dly;
+         plan_dly_list.back().msg = cosim_msg_pool.read( chn_plan_adap );
+      }
+
+      plan_dly_evnt.notify( sc_core::SC_ZERO_TIME );
+
+      sc_core::wait( chn_plan_adap.data_written_event() );
+   } // for(;;)
+} // void cosim_adapter_c::plan_thrd(
+
+void cosim_adapter_c::done_thrd(
+      void ) {
+   if(( plan_dly == sc_core::SC_ZERO_TIME && !lt_mode ) ||
+       part_mode == PART_SIMD ) {
+      return;
+   }
+
+   // Completions leave in the order they were produced
+   for(;;) {
+      if( done_dly_list.empty() ) {
+         sc_core::wait( done_dly_evnt );
+      }
+      else if( done_dly_list.front().due > sc_core::sc_time_stamp() ) {
+         sc_core::wait( done_dly_list.front().due - sc_core::sc_time_stamp() );
+      }
+      else {
+         chn_adap_plan.write( done_dly_list.front().msg.sig() ); // Write data to the output
+         done_dly_list.pop_front();
+      }
+   } // for(;;)
+} // void cosim_adapter_c::done_thrd(
+
+bool cosim_adapter_c::exec_idle(
+      void ) {
+   return plan_msg.empty()                    &&
+          conf_ready.empty()                  &&
+          done_stage.empty()                  &&
+          rply_list.empty()                   &&
+          evnt_sig_num == 0                   &&
+          stat_sig_num == 0                   &&
+          ( park_hold != 0 ||
+            ( plan_dly_list.empty() &&
+              chn_plan_adap.num_available() == 0 )) &&
+          event_i->num_available() == 0       &&
+          busr_i->num_available()  == 0;
+} // cosim_adapter_c::exec_idle(
+
+bool cosim_adapter_c::gate_enabled(
+      void ) const {
+   return gate_idle != 0;
+} // bool cosim_adapter_c::gate_enabled(
+
+void cosim_adapter_c::gate_mthd(
+      void ) {
+   if( gate_idle == 0 ||
+       clock_o.size() == 0 ) { // No gating. The method is not triggered again
+      next_trigger( gate_wake_evnt );
+      return;
+   }
+
+   if( !gate_run ) { // New input. clock_o follows clock_i from the next edge
+      gate_run = true;
+
+      if( stat_en ) {
+         stat_gate_time += sc_core::sc_time_stamp() - gate_stop_time;
+      }
+
+      return;
+   }
+
+   clock_o->write( clock_i.read());
+
+   if( gate_stop && !clock_i.read()) { // Stopped at the falling edge, clock_o stays low
+      gate_run       = false;
+      gate_stop_time = sc_core::sc_time_stamp();
+
+      if( stat_en ) {
+         stat_gate_stop ++;
+      }
+
+      next_trigger( gate_wake_evnt );
+   }
+} // void cosim_adapter_c::gate_mthd(
+
+bool cosim_adapter_c::exec_ready(
+      void ) {
+   // New jobs are taken when the config list of the previous job is written
+   bool plan_ready = plan_msg.empty() ? ( !conf_ready.empty() || plan_avail()) : !busw_wait();
+
+   return plan_ready                          ||
+          !done_stage.empty()                 ||
+          ( !rply_list.empty() && rply_list.begin()->first <= time_local() ) ||
+          evnt_sig_num != 0                   ||
+          stat_sig_num != 0                   ||
+          event_i->num_available() != 0       ||
+          busr_i->num_available()  != 0;
+} // cosim_adapter_c::exec_ready(
+
+bool cosim_adapter_c::busw_wait(
+      void ) {
+   return busw_full && busw_o->num_free() == 0;
+} // bool cosim_adapter_c::busw_wait(
+
+sc_core::sc_time cosim_adapter_c::time_local(
+      void ) const {
+   return sc_core::sc_time_stamp() + lt_offset;
+} // sc_core::sc_time cosim_adapter_c::time_local(
+
+void cosim_adapter_c::lt_sync(
+      void ) {
+   if( lt_offset != sc_core::SC_ZERO_TIME ) {
+      sc_core::wait( lt_offset );
+
+      lt_offset = sc_core::SC_ZERO_TIME;
+
+      if( stat_en ) {
+         stat_lt_sync ++;
+      }
+   }
+} // void cosim_adapter_c::lt_sync(
+
 void cosim_adapter_c::exec_thrd(
       void ) {
-   schd::schd_sig_ptree_c schd_pt_out;
+   if( part_mode == PART_PLAN ) {
+      return;
+   }
+
    simd::simd_sig_ptree_c simd_pt_out;
 
-   schd_dump_buf_c<boost_pt::ptree> dump_buf_plan_i( std::string( name()) + ".plan_i" );
-   schd_dump_buf_c<boost_pt::ptree> dump_buf_plan_o( std::string( name()) + ".plan_o" );
-   schd_dump_buf_c<boost_pt::ptree> dump_buf_busr_i( std::string( name()) + ".busr_i" );
-   schd_dump_buf_c<boost_pt::ptree> dump_buf_busw_o( std::string( name()) + ".busw_o" );
-   schd_dump_buf_c<boost_pt::ptree> dump_buf_evnt_i( std::string( name()) + ".evnt_i" );
+   cosim_dump_c dump_buf_plan_i( std::string( name()) + ".plan_i" );
+   cosim_dump_c dump_buf_plan_o( std::string( name()) + ".plan_o" );
+   cosim_dump_c dump_buf_busr_i( std::string( name()) + ".busr_i" );
+   cosim_dump_c dump_buf_busw_o( std::string( name()) + ".busw_o" );
+   cosim_dump_c dump_buf_evnt_i( std::string( name()) + ".evnt_i" );
+
+   busw_size = busw_o->num_free(); // busw_o is empty at start
+
+   if( lt_mode ) { // Measure the clock period. Thread starts at the clock edge
+      sc_core::sc_time start_time = sc_core::sc_time_stamp();
 
-   for(;;) {
       sc_core::wait();
 
+      lt_cycle  = sc_core::sc_time_stamp() - start_time;
+      lt_offset = sc_core::SC_ZERO_TIME;
+   }
+
+   for(;;) {
+      if( lt_mode ) { // Runs ahead of the kernel until the quantum is used up or there is nothing to do
+         if( lt_offset >= lt_quantum ) {
+            lt_sync();
+         }
+         else if( !exec_ready() ) {
+            lt_sync();
+
+            if( !exec_ready() ) { // Sleep until any of the input fifos is written or a packet leaves the latency stage
+               sc_core::sc_event_or_list wake_list;
+
+               wake_list |= chn_plan_adap.data_written_event();
+               wake_list |= plan_dly_evnt;
+               wake_list |= event_i->data_written_event();
+               wake_list |= busr_i->data_written_event();
+               wake_list |= reset_i.value_changed_event();
+
+               if( busw_full ) { // The rest of the config list waits for the core to read busw_o
+                  wake_list |= busw_o->data_read_event();
+               }
+
+               // Next packet leaving the latency stage or the next replayed completion
+               sc_core::sc_time wake_time = sc_core::SC_ZERO_TIME;
+
+               // The planner is not read while parked jobs hold it back. A due packet then waits for a credit
+               if( !plan_dly_list.empty() && plan_msg.empty() &&
+                   park_hold == 0 &&
+                   plan_dly_list.front().due > sc_core::sc_time_stamp()) {
+                  wake_time = plan_dly_list.front().due;
+               }
+
+               if( !rply_list.empty() &&
+                   ( wake_time == sc_core::SC_ZERO_TIME || rply_list.begin()->first < wake_time )) {
+                  wake_time = rply_list.begin()->first;
+               }
+
+               if( wake_time == sc_core::SC_ZERO_TIME ) {
+                  sc_core::wait( wake_list );
+               }
+               else {
+                  sc_core::wait( wake_time - sc_core::sc_time_stamp(), wake_list );
+               }
+            }
+         }
+
+         lt_offset += lt_cycle;
+      }
+      else if( wake_evnt && exec_idle() &&
+               ( gate_idle == 0 || gate_stop )) { // Sleep until any of the input fifos is written
+         sc_core::wait(
+               chn_plan_adap.data_written_event() |
+               plan_dly_evnt                      |
+               event_i->data_written_event()      |
+               busr_i->data_written_event()       |
+               reset_i.value_changed_event() );
+
+         if( !clock_i.posedge() ) { // Align to the clock unless woken up at the clock edge
+            sc_core::wait();
+         }
+      }
+      else {
+         sc_core::wait();
+      }
+
+      // Clock of the SIMD core is stopped after gate_idle idle cycles without outstanding jobs
+      // and resumed when there is new input
+      if( gate_idle != 0 ) {
+         bool core_idle = exec_idle() && job_actv == 0;
+
+         gate_cnt = core_idle ? gate_cnt + 1 : 0;
+
+         if( gate_stop && !core_idle ) {
+            gate_stop = false;
+            gate_wake_evnt.notify( sc_core::SC_ZERO_TIME );
+         }
+         else if( !gate_stop && gate_cnt >= gate_idle ) {
+            gate_stop = true;
+         }
+      }
+
+      if( stat_en ) {
+         stat_cycle ++;
+         hist_plan_depth.add( chn_plan_adap.num_available() + plan_dly_list.size() );
+         hist_done_depth.add( chn_adap_plan.num_available() + done_dly_list.size() + done_stage.size() );
+         hist_evnt_depth.add( event_i->num_available() );
+         hist_busr_depth.add( busr_i->num_available() );
+      }
+
+      // Completions staged at the previous clock cycles
+      done_flush();
+
       bool plan_new = true;
       bool evnt_new = true;
       bool stat_new = true;
 
-      if( !plan_pt.empty() ) { // New data from planner was fetched from fifo at the previous clock cycle
-         if( conf_it->first.empty()) {
-            SCHD_REPORT_ERROR( "cosim::adapter" ) << name() <<  " Incorrect config structure";
-         }
+      // Config and completion paths don't block each other. The rest of the config list is staged
+      // while busw_o is full and the completions are staged while chn_adap_plan is full
+      if( !plan_msg.empty() ) { // New data from planner was fetched from fifo at the previous clock cycle
+         std::size_t conf_cnt = 0;
 
-         busw_o->write( simd_pt_out.set( conf_it->second )); // Write data to the output
+         busw_full = false;
 
-         // Dump pt packets as they depart from the output of the block
-         dump_buf_busw_o.write( conf_it->second, BUF_WRITE_LAST );
+         do { // Up to conf_burst words in one clock cycle
+            if( conf_it->first.empty()) {
+               SCHD_REPORT_ERROR( "cosim::adapter" ) << name() <<  " Incorrect config structure";
+            }
 
-         conf_it = std::next( conf_it );
+            if( !busw_o->nb_write( simd_pt_out.set( conf_it->second ))) { // Write data to the output. Retried at the next clock cycle
+               busw_full = true;
+
+               if( stat_en ) {
+                  stat_busw_stall ++;
+               }
+
+               break;
+            }
+
+            busw_cnt ++;
+
+            if( stat_en ) {
+               stat_conf ++;
+            }
+
+            // Dump pt packets as they depart from the output of the block
+            dump_buf_busw_o.write( conf_it->second );
+            cosim_rec.busw( core_rec_idx, time_local(), conf_it->second );
+
+            conf_it = std::next( conf_it );
+            conf_cnt ++;
+
+            if( lt_mode && conf_cnt > 1 ) { // One clock cycle per config word
+               lt_offset += lt_cycle;
+            }
+         } while( conf_it != conf_p.get().end() &&
+                  ( conf_burst == 0 || conf_cnt < conf_burst ));
 
          if( conf_it == conf_p.get().end()) {
+            if( credit_mode == CREDIT_STATUS &&
+                plan_blck != blck_none ) { // Slot stays pending until the core reads the last word
+               pend_list.push_back( pend_data_t());
+               pend_list.back().busw_last = busw_cnt;
+               pend_list.back().blck_idx  = plan_blck;
+            }
+
             conf_p.reset();
-            plan_pt.clear();
+            plan_msg.reset();
          }
          else {
             plan_new = false;
          }
-      } // if( !plan_pt.empty() )
+      } // if( !plan_msg.empty() )
+
+      // New events were fetched from fifo at the previous clock cycle
+      for( std::size_t sig_idx = 0; sig_idx < evnt_sig_num; sig_idx ++ ) {
+         const boost_pt::ptree& evnt_pt = evnt_sig_list[sig_idx].get();
 
-      if( !evnt_pt.empty() ) { // New event was fetched from fifo at the previous clock cycle
-         // Build full hierarchical event name
-         boost::optional<std::string> src_p  = evnt_pt.get_optional<std::string>( "source"   );
-         boost::optional<std::string> evnt_p = evnt_pt.get_optional<std::string>( "event_id" );
+         // Resolve full hierarchical event name: core.source.event_id
+         const std::string* src_p  = child_data( evnt_pt, "source"   );
+         const std::string* evnt_p = child_data( evnt_pt, "event_id" );
 
-         if( !src_p.is_initialized() ||
-             !evnt_p.is_initialized() ) {
+         if( src_p  == nullptr ||
+             evnt_p == nullptr ) {
             SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect event structure";
          }
 
          // Calculate hash
-         std::string evnt_str  = core_name + "." + src_p.get() + "." + evnt_p.get();
-         std::size_t evnt_hash = 0;
-         boost::hash_combine(
-               evnt_hash,
-               evnt_str );
+         std::size_t evnt_hash = name_hash( name_hash( name_hash( name_hash( name_hash( 0,
+               core_name ), "." ), *src_p ), "." ), *evnt_p );
 
-         auto evnt_cliq_it = evnt_cliq_list.find( evnt_hash );
+         std::size_t evnt_idx = evnt_find( evnt_hash );
 
-         if( evnt_cliq_it == evnt_cliq_list.end()) {
+         if( evnt_idx == evnt_none ||
+             !evnt_match( evnt_list[evnt_idx].event, *src_p, *evnt_p )) {
             SCHD_REPORT_ERROR( "cosim::adapter" )
                   << name()
                   << " Unresolved event hash for: "
-                  << evnt_str;
+                  << core_name << "." << *src_p << "." << *evnt_p;
+         }
+
+         evnt_data_t& evnt_data = evnt_list[evnt_idx];
+
+         if( credit_mode == CREDIT_EVENT &&
+             evnt_data.blck_slot ) { // Config slot of the job is free
+            evnt_data.blck_slot = false;
+            credit_set( evnt_data.blck_idx, blck_list[evnt_data.blck_idx].credit + 1 );
          }
 
-         if( evnt_cliq_it->second.clique_p.is_initialized() ) { // Event is a member of a clique
-            cliq_evnt_list_t::value_type &clique_r = evnt_cliq_it->second.clique_p.get();
+         if( evnt_data.cliq_idx != cliq_none ) { // Event is a member of a clique
+            std::size_t  cliq_idx  = evnt_data.cliq_idx;
+            cliq_data_t& cliq_data = cliq_pool[cliq_idx];
 
-            clique_r.second.evnt_count --;
+            cliq_data.evnt_count --;
 
-            if( clique_r.second.evnt_count == 0 ) {
-               BOOST_FOREACH( boost::optional<evnt_data_t &> evnt_ptr_el, clique_r.second.evnt_ptr_list ) {
-                  evnt_ptr_el.get().job_hash = 0;
-                  evnt_ptr_el.get().clique_p.reset();
+            if( cliq_data.evnt_count == 0 ) {
+               if( stat_en ) {
+                  hist_cliq_lat.add( time2val( time_local() - cliq_data.start_time ));
+               }
 
-                  boost_pt::ptree exec_pt;
-                  boost_pt::ptree dst_list_pt;
-                  dst_list_pt.push_back( std::make_pair( "", boost_pt::ptree().put( "", "planner" ) ));
+               for( std::size_t memb_idx = 0; memb_idx < cliq_data.memb_count; memb_idx ++ ) {
+                  evnt_data_t& memb_data = evnt_list[cliq_data.memb_list[memb_idx]];
 
-                  exec_pt.put(       "src",  evnt_ptr_el.get().event );  // Name of this executor
-                  exec_pt.put_child( "dst",  dst_list_pt             );  // Destination: planner
+                  job_hash_set( memb_data, 0 );
+                  memb_data.cliq_idx = cliq_none;
 
-                  plan_eo->write( schd_pt_out.set( exec_pt )); // Write data to the output
+                  done_write( memb_data.done_msg ); // Write data to the output
 
                   // Dump pt packets as they depart from the output of the block
-                  dump_buf_plan_o.write( exec_pt, BUF_WRITE_LAST );
+                  dump_buf_plan_o.write( memb_data.done_msg.get() );
                }
 
-               cliq_evnt_list.erase( clique_r.first );
+               cliq_release( cliq_idx );
             }
-         } // if( evnt_cliq_it->second.clique_p.is_initialized() )
+         } // if( evnt_data.cliq_idx != cliq_none )
          else { // No clique specification. Report the completion straight away
-            evnt_cliq_it->second.job_hash = 0;
+            job_hash_set( evnt_data, 0 );
 
-            boost_pt::ptree exec_pt;
-            boost_pt::ptree dst_list_pt;
-            dst_list_pt.push_back( std::make_pair( "", boost_pt::ptree().put( "", "planner" ) ));
+            done_write( evnt_data.done_msg ); // Write data to the output
 
-            exec_pt.put(       "src",  evnt_str    );  // Name of this executor
-            exec_pt.put_child( "dst",  dst_list_pt );  // Destination: planner
+            // Dump pt packets as they depart from the output of the block
+            dump_buf_plan_o.write( evnt_data.done_msg.get() );
+         } // if( evnt_data.cliq_idx != cliq_none ) ... else ...
+      } // for( std::size_t sig_idx = 0; sig_idx < evnt_sig_num; sig_idx ++ )
 
-            plan_eo->write( schd_pt_out.set( exec_pt )); // Write data to the output
+      evnt_sig_num = 0;
 
-            // Dump pt packets as they depart from the output of the block
-            dump_buf_plan_o.write( exec_pt, BUF_WRITE_LAST );
-         } // if( evnt_cliq_it->second.clique_p.is_initialized() ) ... else ...
-      } // if( !evnt_pt.empty() )
+      // New status was fetched from fifo at the previous clock cycle
+      if( stat_sig_num != 0 && credit_mode == CREDIT_STATUS ) {
+         pend_retire();
+      }
+
+      for( std::size_t sig_idx = 0; sig_idx < stat_sig_num && credit_mode == CREDIT_STATUS; sig_idx ++ ) {
+         const boost_pt::ptree& stat_pt = stat_sig_list[sig_idx].get();
+
+         // Free config slots of the block
+         const std::string* src_p  = child_data( stat_pt, "source"       );
+         const std::string* slot_p = child_data( stat_pt, "config_slots" );
+
+         if( src_p == nullptr || slot_p == nullptr ) { // Other status is not used
+            continue;
+         }
+
+         std::size_t blck_idx = blck_find( *src_p );
+
+         if( blck_idx != blck_none ) {
+            try {
+               // Slots taken by the config lists which the block had not read when it reported
+               std::size_t slot_free = std::stoul( *slot_p );
+               std::size_t slot_pend = blck_list[blck_idx].pend;
+
+               credit_set( blck_idx, ( slot_free > slot_pend ) ? slot_free - slot_pend : 0 );
+            }
+            catch( const std::exception& err ) {
+               SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect status from: " << *src_p << " " << err.what();
+            }
+         }
+      } // for( std::size_t sig_idx = 0; sig_idx < stat_sig_num && credit_mode == CREDIT_STATUS; sig_idx ++ )
+
+      stat_sig_num = 0;
+
+      // Replayed jobs which are completed after the recorded latency
+      while( !rply_list.empty() &&
+             rply_list.begin()->first <= time_local() ) {
+         evnt_data_t& evnt_data = evnt_list[rply_list.begin()->second];
+
+         rply_list.erase( rply_list.begin());
+
+         job_hash_set( evnt_data, 0 );
 
-      if( !stat_pt.empty() ) { // New status was fetched from fifo at the previous clock cycle
-         ; // Do nothing
+         done_write( evnt_data.done_msg ); // Write data to the output
+
+         // Dump pt packets as they depart from the output of the block
+         dump_buf_plan_o.write( evnt_data.done_msg.get() );
+      }
+
+      // Jobs which waited for a free config slot go before the new jobs
+      if( plan_new && !conf_ready.empty()) {
+         plan_msg  = std::move( conf_ready.front().msg );
+         plan_blck = conf_ready.front().blck_idx;
+         conf_ready.pop_front();
+
+         conf_p   = plan_msg.get().get_child( "options.config" );
+         conf_it  = conf_p.get().begin();
+         plan_new = false;
       }
 
       // Read data from schd planner fifo
-      while( plan_ei->num_available() != 0 && plan_new ) {
-         plan_pt = plan_ei->read().get();
+      while( plan_avail() && plan_new ) {
+         plan_read();
 
-         boost::optional<std::string> dst_p  = plan_pt.get_optional<std::string>( "dst" );
+         const boost_pt::ptree& plan_pt = plan_msg.get();
+         const std::string*     dst_p   = child_data( plan_pt, "dst" );
 
-         if( !dst_p.is_initialized() ) {
+         if( dst_p == nullptr ) {
             SCHD_REPORT_ERROR( "cosim::adapter" ) << name() << " Incorrect data structure";
          }
 
-         std::size_t evnt_hash = 0;
-         boost::hash_combine(
-               evnt_hash,
-               dst_p.get() );
-
-         auto evnt_cliq_it = evnt_cliq_list.find( evnt_hash );
+         std::size_t evnt_idx = evnt_find( name_hash( 0, *dst_p ));
 
-         if( evnt_cliq_it == evnt_cliq_list.end()) {
+         if( evnt_idx == evnt_none ||
+             evnt_list[evnt_idx].event != *dst_p ) {
             SCHD_REPORT_ERROR( "cosim::adapter" ) << name()
                                                   << " Unresolved event name: "
-                                                  << dst_p.get();
+                                                  << *dst_p;
          }
 
+         evnt_data_t& evnt_data = evnt_list[evnt_idx];
+
          // Set job hash
-         boost::optional<std::string>      thrd_p = plan_pt.get_optional<std::string>("thread"); // Tread name
-         boost::optional<std::string>      task_p = plan_pt.get_optional<std::string>("task");   // task name
-         boost::optional<boost_pt::ptree&> para_p = plan_pt.get_child_optional("param");         // parameters ptree
-         boost::optional<boost_pt::ptree&> optn_p = plan_pt.get_child_optional("options");       // options ptree
+         const std::string* thrd_p = child_data( plan_pt, "thread" );               // Tread name
+         const std::string* task_p = child_data( plan_pt, "task"   );               // task name
+         boost::optional<const boost_pt::ptree&> para_p = plan_pt.get_child_optional("param");   // parameters ptree
+         boost::optional<const boost_pt::ptree&> optn_p = plan_pt.get_child_optional("options"); // options ptree
 
-         if( !thrd_p.is_initialized() ||
-             !task_p.is_initialized() ||
+         if( thrd_p == nullptr ||
+             task_p == nullptr ||
              !para_p.is_initialized() ||
              !optn_p.is_initialized()) {
             std::string plan_pt_str;
@@ -285,9 +1303,9 @@ void cosim_adapter_c::exec_thrd(
          }
 
          // Get parameters id
-         boost::optional<std::string> prid_p = para_p.get().get_optional<std::string>("id");
+         const std::string* prid_p = child_data( para_p.get(), "id" );
 
-         if( !prid_p.is_initialized() ) {
+         if( prid_p == nullptr ) {
             std::string plan_pt_str;
 
             SCHD_REPORT_ERROR( "cosim::adapter" ) << name()
@@ -296,60 +1314,98 @@ void cosim_adapter_c::exec_thrd(
          }
 
          // Update job hash
-         std::string job_tag = schd_trace.job_comb(
-               thrd_p.get(),
-               task_p.get(),
-               prid_p.get());
-
-         evnt_cliq_it->second.job_hash = 0;
-         boost::hash_combine(
-               evnt_cliq_it->second.job_hash,
-               job_tag  );
+         job_hash_set(
+               evnt_data,
+               job_hash_get(
+                     *thrd_p,
+                     *task_p,
+                     *prid_p ));
 
          // Get clique name if any
-         boost::optional<std::string> cliq_p = optn_p.get().get_optional<std::string>("clique");
+         const std::string* cliq_p = child_data( optn_p.get(), "clique" );
 
-         if( cliq_p.is_initialized() &&
-             cliq_p.get().size() != 0 ) {
+         if( cliq_p != nullptr &&
+             cliq_p->size() != 0 &&
+             !rply_en ) { // Replay: members of the clique were completed together in the recording
 
-            std::size_t cliq_hash = 0;
-            boost::hash_combine(
-                  cliq_hash,
-                  cliq_p.get() );
+            std::size_t  cliq_idx  = cliq_get( *cliq_p );
+            cliq_data_t& cliq_data = cliq_pool[cliq_idx];
 
-            auto cliq_evnt_it = cliq_evnt_list.find( cliq_hash );
+            if( cliq_data.memb_count == evnt_list.size()) {
+               SCHD_REPORT_ERROR( "cosim::adapter" ) << name()
+                                                     << " Too many members in clique: "
+                                                     << *cliq_p;
+            }
 
-            if( cliq_evnt_it == cliq_evnt_list.end()) {
-               cliq_data_t cliq_data;
-               cliq_data.clique = cliq_p.get();
+            if( cliq_data.memb_count == 0 ) {
+               cliq_data.start_time = time_local();
+            }
 
-               bool done;
-               std::tie( cliq_evnt_it, done ) = cliq_evnt_list.insert( cliq_evnt_list_t::value_type( cliq_hash, cliq_data ));
+            // Add event to the list of members
+            cliq_data.evnt_count ++;
+            // Member list of the slot grows to the widest clique which used it
+            if( cliq_data.memb_count == cliq_data.memb_list.size()) {
+               cliq_data.memb_list.push_back( evnt_idx );
+            }
+            else {
+               cliq_data.memb_list[cliq_data.memb_count] = evnt_idx;
             }
 
-            // Add event to the list of pointers
-            cliq_evnt_it->second.evnt_count ++;
-            cliq_evnt_it->second.evnt_ptr_list.push_back( boost::optional<evnt_data_t &>( evnt_cliq_it->second ));
+            cliq_data.memb_count ++;
 
-            // Update pointer to the clique record
-            evnt_cliq_it->second.clique_p = boost::optional<cliq_evnt_list_t::value_type &>( *cliq_evnt_it );
+            // Update clique slot of the event
+            evnt_data.cliq_idx = cliq_idx;
          }
          else {
-            evnt_cliq_it->second.clique_p.reset();
+            evnt_data.cliq_idx = cliq_none;
          }
 
          // Dump pt packets as they arrive to the input of the block
-         dump_buf_plan_i.write( plan_pt, BUF_WRITE_LAST );
+         dump_buf_plan_i.write( plan_pt );
+
+         // Memoization. Jobs in cliques are always simulated in detail
+         memo_list_t::const_iterator memo_it = memo_list.end();
+
+         if( memo_count != 0 &&
+             !rply_en &&
+             evnt_data.cliq_idx == cliq_none ) {
+            evnt_data.memo_sig = memo_sig_get( evnt_data.job_hash, optn_p.get());
+            memo_it            = memo_list.find( evnt_data.memo_sig );
+
+            if( memo_it != memo_list.end() &&
+                memo_it->second.count >= memo_count ) {
+               evnt_data.memo_sig = 0;
+               stat_memo_hit ++;
+            }
+            else {
+               memo_it = memo_list.end();
+               stat_memo_miss ++;
+            }
+         }
+
+         if( rply_en ) { // No config words are sent in replay
+            rply_list.insert({ time_local() + cosim_rec.lat_next( evnt_data.event ), evnt_idx });
+
+            if( !plan_avail() ) {
+               plan_msg.reset();
+            }
+         }
+         else if( memo_it != memo_list.end()) { // Completed after the cached latency without the SIMD core
+            rply_list.insert({ time_local() + memo_it->second.lat, evnt_idx });
 
-         if( dst_p.get().find( core_name + ".config" ) == 0 ) {
-            if( plan_ei->num_available() == 0 ) {
-               plan_pt.clear();
+            if( !plan_avail() ) {
+               plan_msg.reset();
+            }
+         }
+         else if( evnt_data.conf ) {
+            if( !plan_avail() ) {
+               plan_msg.reset();
             }
          }
          else {
             conf_p = optn_p.get().get_child_optional("config");
 
-            if( !cliq_p.is_initialized()) {
+            if( cliq_p == nullptr ) {
                std::string plan_pt_str;
 
                SCHD_REPORT_ERROR( "cosim::adapter" ) << name()
@@ -358,31 +1414,80 @@ void cosim_adapter_c::exec_thrd(
             }
 
             if( conf_p.get().size() == 0 ) {
-               if( plan_ei->num_available() == 0 ) {
-                  plan_pt.clear();
+               if( !plan_avail() ) {
+                  plan_msg.reset();
+               }
+            }
+            else if( evnt_data.blck_idx != blck_none &&
+                     blck_list[evnt_data.blck_idx].credit == 0 ) { // No free config slots. The job is parked
+               blck_data_t& blck_data = blck_list[evnt_data.blck_idx];
+
+               blck_data.park_list.push_back( std::move( plan_msg ));
+               plan_msg.reset();
+               conf_p.reset();
+
+               if( stat_en ) {
+                  stat_credit_wait ++;
+               }
+
+               evnt_data.blck_slot = true; // Slot is taken when the job gets the credit
+
+               if( blck_data.park_list.size() == 2 ) { // The planner is not read until a slot is free
+                  park_hold ++;
                }
             }
             else {
-               conf_it = conf_p.get().begin();
+               if( evnt_data.blck_idx != blck_none ) {
+                  blck_list[evnt_data.blck_idx].credit --;
+                  evnt_data.blck_slot = true;
+
+                  if( credit_mode == CREDIT_STATUS ) {
+                     blck_list[evnt_data.blck_idx].pend ++;
+                  }
+               }
+
+               plan_blck = evnt_data.blck_idx;
+               conf_it   = conf_p.get().begin();
                break;
             }
          }
       }
 
-      // Read data from simd event fifo
-      if( event_i->num_available() != 0 && evnt_new ) {
-         evnt_pt = event_i->read().get();
+      // Read data from simd event fifo. Up to evnt_drain packets in one clock cycle
+      while( event_i->num_available() != 0 && evnt_new ) {
+         if( evnt_sig_num == evnt_sig_list.size()) {
+            evnt_sig_list.push_back( simd::simd_sig_ptree_c());
+         }
+
+         event_i->read( evnt_sig_list[evnt_sig_num] );
+
+         if( stat_en ) {
+            stat_evnt ++;
+         }
 
          // Dump pt packets as they arrive to the input of the block
-         dump_buf_evnt_i.write( evnt_pt, BUF_WRITE_LAST );
+         dump_buf_evnt_i.write( evnt_sig_list[evnt_sig_num].get() );
+         cosim_rec.evnt( core_rec_idx, time_local(), evnt_sig_list[evnt_sig_num ++].get() );
+
+         evnt_new = ( evnt_drain == 0 || evnt_sig_num < evnt_drain );
       }
 
-      // Read data from simd status fifo
-      if( busr_i->num_available() != 0 && stat_new ) {
-         stat_pt = busr_i->read().get();
+      // Read data from simd status fifo. Up to evnt_drain packets in one clock cycle
+      while( busr_i->num_available() != 0 && stat_new ) {
+         if( stat_sig_num == stat_sig_list.size()) {
+            stat_sig_list.push_back( simd::simd_sig_ptree_c());
+         }
+
+         busr_i->read( stat_sig_list[stat_sig_num] );
+
+         if( stat_en ) {
+            stat_busr ++;
+         }
 
          // Dump pt packets as they arrive to the input of the block
-         dump_buf_busr_i.write( stat_pt, BUF_WRITE_LAST );
+         dump_buf_busr_i.write( stat_sig_list[stat_sig_num ++].get() );
+
+         stat_new = ( evnt_drain == 0 || stat_sig_num < evnt_drain );
       }
    } // for(;;)
 } // void cosim_adapter_c::exec_thrd(
@@ -0,0 +1,137 @@
+#include <boost/property_tree/json_parser.hpp>
+#include "schd_common.h"
+#include "cosim_adapter.h"
+#include "cosim_adapter_tb.h"
+#include "cosim_conv.h"
+#include "cosim_pref.h"
+#include "cosim_stat.h"
+
+int sc_main(
+   int argc,
+   char *argv[] ) {
+
+   // Check command line arguments
+   if( argc == 2 ) {
+      SCHD_REPORT_INFO( "cosim::cmdline" ) << "Testbench preferences file: " << argv[1];
+
+      schd::cosim_pref.load( argv[1] );
+   }
+   else {
+      SCHD_REPORT_ERROR( "cosim::cmdline" ) << "Incorrect command line arguments";
+   }
+
+   schd::schd_report.init(
+         schd::cosim_pref.get_pref( "report" ));
+
+   schd::schd_time.init(
+         schd::cosim_pref.get_pref( "time" ));
+
+   sc_core::sc_set_time_resolution(
+         schd::schd_time.res_sec,
+         sc_core::SC_SEC );
+
+   boost::optional<const boost_pt::ptree&> tb_pref_p =
+         schd::cosim_pref.get_pref( "adapter_tb" );
+
+   std::string clock_per = "10ns";
+   std::string res_file  = "adapter_tb_results.json";
+   int         fifo_size = 16;
+
+   if( tb_pref_p.is_initialized()) {
+      clock_per = tb_pref_p.get().get<std::string>( "clock",      clock_per );
+      res_file  = tb_pref_p.get().get<std::string>( "results",    res_file  );
+      fifo_size = std::stoi( tb_pref_p.get().get<std::string>( "fifo_depth", "16" ));
+   }
+
+   // Stub planner. Each lane is the adapter of the core "tb<lane>" with its stub SIMD core
+   schd::cosim_tb_plan_c plan_i0(
+         "tb_plan" );
+   plan_i0.init(
+         tb_pref_p,
+         schd::cosim_pref.get_pref( "adapter" ));
+
+   // Statistics of the adapters
+   schd::cosim_stat_c stat_i0(
+         "stats" );
+   stat_i0.init(
+         schd::cosim_pref.get_pref( "cosim" ));
+
+   // Create clock and reset. The planner clocks the lane of the running test
+   sc_core::sc_clock        clock( "clock", schd::str2time( clock_per ));
+   sc_core::sc_signal<bool> reset( "reset" );
+
+   plan_i0.clock_i.bind( clock );
+
+   for( std::size_t lane_idx = 0; lane_idx < plan_i0.lane_num_get(); lane_idx ++ ) {
+      const std::string& core_name = plan_i0.core_name_get( lane_idx );
+
+      schd::cosim_tb_simd_c* simd_p = new schd::cosim_tb_simd_c( core_name.c_str());
+      simd_p->init(
+            plan_i0.slots_get( lane_idx ));
+
+      schd::cosim_adapter_c* adpt_p = new schd::cosim_adapter_c(( core_name + "_adpt" ).c_str());
+      adpt_p->init(
+            boost::optional<const boost_pt::ptree&>( plan_i0.exec_pref_get( lane_idx )),
+            boost::optional<const boost_pt::ptree&>( plan_i0.core_pref_get( lane_idx )),
+            boost::optional<const boost_pt::ptree&>( plan_i0.adpt_pref_get( lane_idx )));
+
+      plan_i0.core_add(
+            *simd_p );
+      stat_i0.add_adapter(
+            *adpt_p );
+
+      // Connect the adapter with the planner and the stub SIMD core
+      std::string chn_name = core_name + "_chn_";
+
+      sc_core::sc_signal<bool>*                 clock_p  = new sc_core::sc_signal<bool>(( core_name + "_clock" ).c_str());
+      sc_core::sc_fifo<simd::simd_sig_ptree_c>* busw_p   = new sc_core::sc_fifo<simd::simd_sig_ptree_c>(( chn_name + "busw" ).c_str(), fifo_size );
+      sc_core::sc_fifo<simd::simd_sig_ptree_c>* evnt_p   = new sc_core::sc_fifo<simd::simd_sig_ptree_c>(( chn_name + "evnt" ).c_str(), fifo_size );
+      sc_core::sc_fifo<simd::simd_sig_ptree_c>* busr_p   = new sc_core::sc_fifo<simd::simd_sig_ptree_c>(( chn_name + "busr" ).c_str(), fifo_size );
+
+      plan_i0.clock_o[lane_idx].bind( *clock_p );
+
+      adpt_p->clock_i.bind( *clock_p );
+      adpt_p->reset_i.bind( reset );
+      adpt_p->busw_o.bind(  *busw_p );
+      adpt_p->event_i.bind( *evnt_p );
+      adpt_p->busr_i.bind(  *busr_p );
+
+      // Stub SIMD core is not clocked. The gated clock of the adapter is not used
+      if( adpt_p->gate_enabled()) {
+         adpt_p->clock_o.bind( *new sc_core::sc_signal<bool>(( core_name + "_clock_gate" ).c_str()));
+      }
+
+      simd_p->busw_i.bind(  *busw_p );
+      simd_p->event_o.bind( *evnt_p );
+      simd_p->busr_o.bind(  *busr_p );
+
+      plan_i0.plan_o[lane_idx].bind( adpt_p->plan_eo );
+      plan_i0.done_i[lane_idx].bind( adpt_p->plan_ei );
+   } // for( std::size_t lane_idx = 0; lane_idx < plan_i0.lane_num_get(); lane_idx ++ )
+
+   // Init data dump class for schd
+   if( schd::cosim_pref.get_pref( "dump" ).is_initialized()) {
+      schd::schd_dump.init(
+            schd::cosim_pref.get_pref( "dump" ));
+   }
+
+   // Runs until the stub planner is done with the tests
+   sc_core::sc_start();
+
+   boost_pt::ptree res_pt;
+   std::size_t     err_num = plan_i0.result_get( res_pt );
+
+   try {
+      boost_pt::write_json( res_file, res_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::adapter_tb" ) << err.what();
+   }
+
+   SCHD_REPORT_INFO( "cosim::adapter_tb" ) << "Results: " << res_file << " Errors: " << err_num;
+
+   stat_i0.dump();
+   schd::schd_dump.close_all();
+
+   return ( err_num != 0 ) ? 1 : 0;
+}
@@ -0,0 +1,390 @@
+/*
+ * cosim_adapter_tb_plan.cpp
+ *
+ *  Description: Stub planner of the adapter testbench
+ */
+
+#include <chrono>
+#include <algorithm>
+#include <boost/foreach.hpp>
+#include "cosim_adapter_tb.h"
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+SC_HAS_PROCESS( schd::cosim_tb_plan_c );
+cosim_tb_plan_c::cosim_tb_plan_c(
+      sc_core::sc_module_name nm )
+   : sc_core::sc_module( nm )
+   , clock_i( "clock_i" )
+   , clock_o( "clock_o" )
+   , plan_o(  "plan_o"  )
+   , done_i(  "done_i"  ) {
+
+   // Process registrations
+   SC_THREAD( exec_thrd );
+
+   SC_METHOD( clock_mthd ); // Clock of the lane of the running test
+   sensitive << clock_i;
+   dont_initialize();
+} // cosim_tb_plan_c::cosim_tb_plan_c(
+
+void cosim_tb_plan_c::init(
+      boost::optional<const boost_pt::ptree&> tb_pref_p,
+      boost::optional<const boost_pt::ptree&> adpt_pref_p ) {
+   // Lane 0 runs the tests without their own adapter preferences
+   lane_list.push_back( lane_data_t());
+
+   if( adpt_pref_p.is_initialized()) {
+      lane_list.back().adpt_pt = adpt_pref_p.get();
+   }
+
+   if( !tb_pref_p.is_initialized()) {
+      SCHD_REPORT_ERROR( "cosim::adapter_tb" ) << name() << " Testbench preferences are not specified";
+   }
+
+   try {
+      blck_num = std::stoul( tb_pref_p.get().get<std::string>( "blocks", "8" ));
+
+      BOOST_FOREACH( const boost_pt::ptree::value_type& test_el, tb_pref_p.get().get_child( "tests" )) {
+         if( !test_el.first.empty()) {
+            SCHD_REPORT_ERROR( "cosim::adapter_tb" ) << name() << " Incorrect structure of tests";
+         }
+
+         const boost_pt::ptree& test_pt = test_el.second;
+
+         test_list.push_back( test_data_t());
+         test_data_t& test_data = test_list.back();
+
+         test_data.name     = test_pt.get<std::string>( "name" );
+         test_data.jobs     = std::stoul( test_pt.get<std::string>( "jobs",   "1" ));
+         test_data.blocks   = std::stoul( test_pt.get<std::string>( "blocks", "1" ));
+         test_data.depth    = std::stoul( test_pt.get<std::string>( "depth",  "1" ));
+         test_data.clique   = std::stoul( test_pt.get<std::string>( "clique", "1" ));
+         test_data.config   = std::stoul( test_pt.get<std::string>( "config", "1" ));
+         test_data.status   = std::stoul( test_pt.get<std::string>( "status", "0" ));
+         test_data.hold     = std::stoul( test_pt.get<std::string>( "hold",   "1" ));
+         test_data.reuse    = ( test_pt.get<std::string>( "reuse", "0" ) == "1" );
+         test_data.delay    = test_pt.get<std::string>( "delay", "0" );
+         test_data.interval = str2time( test_pt.get<std::string>( "interval", "0" ));
+         test_data.timeout  = str2time( test_pt.get<std::string>( "timeout", "1ms" ));
+
+         std::size_t slots = std::stoul( test_pt.get<std::string>( "slots", "0" ));
+
+         // Jobs in flight go to the different executors. Cliques and event groups do not span the rounds.
+         // Core with config slots doesn't read the next config list of a busy block, so the events are not held
+         if( test_data.jobs   == 0 || test_data.config == 0 ||
+             test_data.blocks == 0 || test_data.blocks > blck_num ||
+             test_data.depth  == 0 ||
+             test_data.clique == 0 || test_data.blocks % test_data.clique != 0 ||
+             test_data.hold   == 0 || test_data.blocks % test_data.hold   != 0 ||
+             ( slots != 0 && test_data.hold != 1 )) {
+            SCHD_REPORT_ERROR( "cosim::adapter_tb" ) << name() << " Incorrect test: " << test_data.name;
+         }
+
+         dpth_num = std::max( dpth_num, test_data.depth );
+
+         // Own lane for the adapter preferences or config slots of the test
+         boost::optional<const boost_pt::ptree&> test_adpt_p = test_pt.get_child_optional( "adapter" );
+
+         if( test_adpt_p.is_initialized() || slots != 0 ) {
+            test_data.lane = lane_list.size();
+
+            lane_list.push_back( lane_list.front());
+            lane_list.back().slots = slots;
+
+            if( test_adpt_p.is_initialized()) { // Test preferences override the common ones
+               BOOST_FOREACH( const boost_pt::ptree::value_type& adpt_el, test_adpt_p.get()) {
+                  lane_list.back().adpt_pt.put_child( adpt_el.first, adpt_el.second );
+               }
+            }
+         }
+
+         const boost_pt::ptree& lane_adpt_pt = lane_list[test_data.lane].adpt_pt;
+
+         test_data.memo   = lane_adpt_pt.get_child_optional( "memo" ).is_initialized();
+         test_data.credit = ( lane_adpt_pt.get<std::string>( "credit", "none" ) == "event" && slots != 0 );
+      }
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::adapter_tb" ) << name() << " " << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::adapter_tb" ) << name() << " Incorrect testbench preferences: " << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::adapter_tb" ) << name() << " Unexpected";
+   }
+
+   // Blocks of the stub core of each lane and their executors
+   boost_pt::ptree pt;
+
+   for( std::size_t lane_idx = 0; lane_idx < lane_list.size(); lane_idx ++ ) {
+      lane_data_t& lane_data = lane_list[lane_idx];
+
+      lane_data.core_name = "tb" + std::to_string( lane_idx );
+
+      for( std::size_t blck_idx = 0; blck_idx < blck_num; blck_idx ++ ) {
+         std::string blck_name = "b" + std::to_string( blck_idx );
+
+         pt.clear();
+         pt.put( "name", blck_name );
+
+         if( lane_data.slots != 0 ) {
+            pt.put( "param.config_slots", lane_data.slots );
+         }
+
+         lane_data.core_pt.push_back( std::make_pair( "", pt ));
+
+         for( std::size_t dpth_idx = 0; dpth_idx < dpth_num; dpth_idx ++ ) {
+            pt.clear();
+            pt.put( "name", lane_data.core_name + "." + blck_name + ".e" + std::to_string( dpth_idx ));
+            lane_data.exec_pt.push_back( std::make_pair( "", pt ));
+         }
+      }
+   } // for( std::size_t lane_idx = 0; lane_idx < lane_list.size(); lane_idx ++ )
+
+   clock_o.init( lane_list.size());
+   plan_o.init(  lane_list.size());
+   done_i.init(  lane_list.size());
+} // void cosim_tb_plan_c::init(
+
+std::size_t cosim_tb_plan_c::lane_num_get(
+      void ) const {
+   return lane_list.size();
+} // std::size_t cosim_tb_plan_c::lane_num_get(
+
+const std::string& cosim_tb_plan_c::core_name_get(
+      std::size_t                          lane_idx ) const {
+   return lane_list[lane_idx].core_name;
+} // const std::string& cosim_tb_plan_c::core_name_get(
+
+const boost_pt::ptree& cosim_tb_plan_c::exec_pref_get(
+      std::size_t                          lane_idx ) const {
+   return lane_list[lane_idx].exec_pt;
+} // cosim_tb_plan_c::exec_pref_get(
+
+const boost_pt::ptree& cosim_tb_plan_c::core_pref_get(
+      std::size_t                          lane_idx ) const {
+   return lane_list[lane_idx].core_pt;
+} // cosim_tb_plan_c::core_pref_get(
+
+const boost_pt::ptree& cosim_tb_plan_c::adpt_pref_get(
+      std::size_t                          lane_idx ) const {
+   return lane_list[lane_idx].adpt_pt;
+} // cosim_tb_plan_c::adpt_pref_get(
+
+std::size_t cosim_tb_plan_c::slots_get(
+      std::size_t                          lane_idx ) const {
+   return lane_list[lane_idx].slots;
+} // std::size_t cosim_tb_plan_c::slots_get(
+
+void cosim_tb_plan_c::core_add(
+      const cosim_tb_simd_c&               core ) {
+   if( core_idx >= lane_list.size()) {
+      SCHD_REPORT_ERROR( "cosim::adapter_tb" ) << name() << " Incorrect number of cores";
+   }
+
+   lane_list[core_idx ++].core_p = &core;
+} // void cosim_tb_plan_c::core_add(
+
+std::size_t cosim_tb_plan_c::result_get(
+      boost_pt::ptree&                     res_pt ) const {
+   std::size_t     err_num = 0;
+   boost_pt::ptree test_list_pt;
+
+   BOOST_FOREACH( const test_data_t& test_data, test_list ) {
+      boost_pt::ptree test_pt;
+
+      test_pt.put( "name",        test_data.name );
+      test_pt.put( "packets",     test_data.pckt_num );
+      test_pt.put( "errors",      test_data.err_num );
+      test_pt.put( "host_sec",    test_data.host_sec );
+      test_pt.put( "host_ns_per_packet",
+                   ( test_data.pckt_num != 0 ) ? test_data.host_sec * 1e9 / test_data.pckt_num : 0.0 );
+      test_pt.put( "sim_time",    test_data.sim_time.to_string());
+      test_pt.put( "core_jobs",   test_data.core_jobs );
+      test_pt.put( "slot_wait",   test_data.slot_wait );
+
+      test_list_pt.push_back( std::make_pair( "", test_pt ));
+      err_num += test_data.err_num;
+   }
+
+   res_pt.put( "errors", err_num );
+   res_pt.add_child( "tests", test_list_pt );
+
+   return err_num;
+} // std::size_t cosim_tb_plan_c::result_get(
+
+void cosim_tb_plan_c::error(
+      test_data_t&                         test_data,
+      const std::string&                   msg ) {
+   test_data.err_num ++;
+
+   SCHD_REPORT_INFO( "cosim::adapter_tb" ) << name() << " Test: " << test_data.name << " Fail: " << msg;
+} // void cosim_tb_plan_c::error(
+
+void cosim_tb_plan_c::exec_thrd(
+      void ) {
+   BOOST_FOREACH( test_data_t& test_data, test_list ) {
+      test_run( test_data );
+
+      SCHD_REPORT_INFO( "cosim::adapter_tb" ) << name()
+                                              << " Test: "    << test_data.name
+                                              << " Packets: " << test_data.pckt_num
+                                              << " Host: "    << ( test_data.pckt_num != 0 ?
+                                                                   test_data.host_sec * 1e9 / test_data.pckt_num : 0.0 )
+                                              << "ns/packet"
+                                              << " Errors: "  << test_data.err_num;
+   }
+
+   sc_core::sc_stop();
+} // void cosim_tb_plan_c::exec_thrd(
+
+void cosim_tb_plan_c::clock_mthd(
+      void ) {
+   clock_o[lane_actv]->write( clock_i.read());
+} // void cosim_tb_plan_c::clock_mthd(
+
+void cosim_tb_plan_c::test_run(
+      test_data_t&                         test_data ) {
+   lane_actv = test_data.lane;
+
+   const lane_data_t&     lane_data = lane_list[test_data.lane];
+   const std::string&     core_name = lane_data.core_name;
+   const cosim_tb_simd_c& core      = *lane_data.core_p;
+
+   std::size_t job_start  = core.job_num_get();
+   std::size_t wait_start = core.slot_wait_get();
+
+   std::chrono::steady_clock::time_point host_start = std::chrono::steady_clock::now();
+   sc_core::sc_time                      sim_start  = sc_core::sc_time_stamp();
+
+   // Whole rounds of the jobs in flight
+   std::size_t rnd_jobs = test_data.blocks * test_data.depth;
+   std::size_t rnd_num  = ( test_data.jobs + rnd_jobs - 1 ) / rnd_jobs;
+
+   schd_sig_ptree_c plan_sig;
+   boost_pt::ptree  plan_pt;
+   boost_pt::ptree  conf_list_pt;
+   boost_pt::ptree  word_pt;
+
+   std::unordered_map<std::string, std::size_t>      pend_list;   // Executor -> clique group
+   std::unordered_map<std::size_t, sc_core::sc_time> grp_list;    // Completion time of the group
+
+   for( std::size_t rnd_idx = 0; rnd_idx < rnd_num; rnd_idx ++ ) {
+      pend_list.clear();
+      grp_list.clear();
+
+      for( std::size_t job_idx = 0; job_idx < rnd_jobs; job_idx ++ ) {
+         std::string blck_name = "b" + std::to_string( job_idx % test_data.blocks );
+         std::string evnt_name = "e" + std::to_string( job_idx / test_data.blocks );
+         std::string exec_name = core_name + "." + blck_name + "." + evnt_name;
+         std::size_t grp_idx   = job_idx / test_data.clique;
+
+         conf_list_pt.clear();
+
+         for( std::size_t word_idx = 0; word_idx < test_data.config; word_idx ++ ) {
+            word_pt.clear();
+            word_pt.put( "dst", blck_name );
+            word_pt.put( "idx", word_idx );
+
+            if( word_idx + 1 == test_data.config ) { // Reply of the stub SIMD core
+               word_pt.put( "last",   "1" );
+               word_pt.put( "event",  evnt_name );
+               word_pt.put( "delay",  test_data.delay );
+               word_pt.put( "hold",   test_data.hold );
+               word_pt.put( "status", test_data.status );
+            }
+
+            conf_list_pt.push_back( std::make_pair( blck_name, word_pt ));
+         }
+
+         plan_pt.clear();
+         plan_pt.put( "dst",      exec_name );
+         plan_pt.put( "thread",   "tb" );
+         plan_pt.put( "task",     test_data.name );
+         plan_pt.put( "param.id", ( test_data.reuse ? "" : std::to_string( rnd_idx ) + "_" ) + blck_name + "_" + evnt_name );
+         plan_pt.put( "options.clique", ( test_data.clique > 1 ) ?
+               "cq" + std::to_string( rnd_idx ) + "_" + std::to_string( grp_idx ) : "" );
+         plan_pt.add_child( "options.config", conf_list_pt );
+
+         plan_o[test_data.lane]->write( plan_sig.set( plan_pt ));
+
+         pend_list[exec_name] = grp_idx;
+
+         // Job, config words, event, status and completion
+         test_data.pckt_num += 3 + test_data.config + test_data.status;
+
+         if( test_data.interval != sc_core::SC_ZERO_TIME ) {
+            sc_core::wait( test_data.interval );
+         }
+      } // for( std::size_t job_idx = 0; job_idx < rnd_jobs; job_idx ++ )
+
+      // Collect the completions of the round
+      while( !pend_list.empty()) {
+         if( done_i[test_data.lane]->num_available() == 0 ) {
+            sc_core::wait( test_data.timeout, done_i[test_data.lane]->data_written_event());
+
+            if( done_i[test_data.lane]->num_available() == 0 ) {
+               error( test_data, "Timeout. Outstanding jobs: " + std::to_string( pend_list.size()));
+               break;
+            }
+         }
+
+         schd_sig_ptree_c       done_sig = done_i[test_data.lane]->read();
+         const boost_pt::ptree& done_pt  = done_sig.get();
+         std::string            src      = done_pt.get<std::string>( "src", "" );
+
+         std::unordered_map<std::string, std::size_t>::iterator pend_it = pend_list.find( src );
+
+         if( pend_it == pend_list.end()) {
+            error( test_data, "Unexpected completion: " + src );
+            continue;
+         }
+
+         if( done_pt.get_child( "dst", boost_pt::ptree()).empty() ||
+             done_pt.get_child( "dst" ).front().second.data() != "planner" ) {
+            error( test_data, "Incorrect destination of completion: " + src );
+         }
+
+         // Members of the clique complete together
+         std::unordered_map<std::size_t, sc_core::sc_time>::iterator grp_it = grp_list.find( pend_it->second );
+
+         if( grp_it == grp_list.end()) {
+            grp_list[pend_it->second] = sc_core::sc_time_stamp();
+         }
+         else if( grp_it->second != sc_core::sc_time_stamp()) {
+            error( test_data, "Clique members completed at different times: " + src );
+         }
+
+         pend_list.erase( pend_it );
+      } // while( !pend_list.empty())
+
+      if( !pend_list.empty()) { // Timeout
+         break;
+      }
+   } // for( std::size_t rnd_idx = 0; rnd_idx < rnd_num; rnd_idx ++ )
+
+   test_data.host_sec = std::chrono::duration<double>(
+         std::chrono::steady_clock::now() - host_start ).count();
+   test_data.sim_time = sc_core::sc_time_stamp() - sim_start;
+
+   test_data.core_jobs = core.job_num_get()   - job_start;
+   test_data.slot_wait = core.slot_wait_get() - wait_start;
+
+   // Repeated jobs are completed from the cache after the first rounds
+   if( test_data.memo && test_data.reuse &&
+       test_data.core_jobs >= rnd_num * rnd_jobs ) {
+      error( test_data, "No jobs completed from the memo cache" );
+   }
+
+   // Adapter with the config slot returned by each event doesn't send a config list to a busy block
+   if( test_data.credit &&
+       test_data.slot_wait != 0 ) {
+      error( test_data, "Config lists to the blocks without free config slots: " + std::to_string( test_data.slot_wait ));
+   }
+} // void cosim_tb_plan_c::test_run(
+
+} // namespace schd
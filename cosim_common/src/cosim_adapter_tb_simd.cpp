@@ -0,0 +1,146 @@
+/*
+ * cosim_adapter_tb_simd.cpp
+ *
+ *  Description: Stub SIMD core of the adapter testbench
+ */
+
+#include "cosim_adapter_tb.h"
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+SC_HAS_PROCESS( schd::cosim_tb_simd_c );
+cosim_tb_simd_c::cosim_tb_simd_c(
+      sc_core::sc_module_name nm )
+   : sc_core::sc_module( nm )
+   , busw_i(  "busw_i"  )
+   , event_o( "event_o" )
+   , busr_o(  "busr_o"  ) {
+
+   // Process registrations
+   SC_THREAD( busw_thrd );
+   SC_THREAD( evnt_thrd );
+} // cosim_tb_simd_c::cosim_tb_simd_c(
+
+void cosim_tb_simd_c::init(
+      std::size_t                          slots ) {
+   this->slots = slots;
+} // void cosim_tb_simd_c::init(
+
+std::size_t cosim_tb_simd_c::job_num_get(
+      void ) const {
+   return job_num;
+} // std::size_t cosim_tb_simd_c::job_num_get(
+
+std::size_t cosim_tb_simd_c::slot_wait_get(
+      void ) const {
+   return slot_wait;
+} // std::size_t cosim_tb_simd_c::slot_wait_get(
+
+void cosim_tb_simd_c::busw_thrd(
+      void ) {
+   for(;;) {
+      simd::simd_sig_ptree_c word_sig = busw_i->read();
+      const boost_pt::ptree& word_pt  = word_sig.get();
+
+      std::string  dst      = word_pt.get<std::string>( "dst", "" );
+      std::size_t& word_idx = word_idx_list[dst];
+
+      if( word_pt.get<std::size_t>( "idx", 0 ) != word_idx ) {
+         SCHD_REPORT_ERROR( "cosim::adapter_tb" ) << name() << " Config word out of order for: " << dst
+                                                 << " Expected: " << word_idx;
+      }
+
+      if( word_pt.get<std::string>( "last", "0" ) != "1" ) {
+         word_idx ++;
+         continue;
+      }
+
+      // Last word of the config: the job takes a config slot of the block and starts
+      word_idx = 0;
+
+      if( slots != 0 ) {
+         std::size_t& slot_actv = slot_actv_list[dst];
+
+         if( slot_actv == slots ) {
+            slot_wait ++;
+
+            while( slot_actv == slots ) {
+               sc_core::wait( slot_free );
+            }
+         }
+
+         slot_actv ++;
+      }
+
+      job_num ++;
+
+      evnt_list.push_back( evnt_data_t());
+      evnt_list.back().due      = sc_core::sc_time_stamp() + str2time( word_pt.get<std::string>( "delay", "0" ));
+      evnt_list.back().source   = dst;
+      evnt_list.back().event_id = word_pt.get<std::string>( "event", "done" );
+      evnt_list.back().status   = word_pt.get<std::size_t>( "status", 0 );
+      evnt_list.back().hold     = word_pt.get<std::size_t>( "hold",   1 );
+
+      evnt_new.notify( sc_core::SC_ZERO_TIME );
+   } // for(;;)
+} // void cosim_tb_simd_c::busw_thrd(
+
+void cosim_tb_simd_c::evnt_thrd(
+      void ) {
+   simd::simd_sig_ptree_c simd_sig;
+   boost_pt::ptree        pt;
+
+   for(;;) {
+      if( evnt_list.empty() || evnt_list.size() < evnt_list.front().hold ) {
+         sc_core::wait( evnt_new );
+         continue;
+      }
+
+      // Events of the group are released together, when the last of them is due
+      std::size_t hold = evnt_list.front().hold;
+      sc_core::sc_time due = evnt_list[hold - 1].due;
+
+      if( due > sc_core::sc_time_stamp()) {
+         sc_core::wait( due - sc_core::sc_time_stamp());
+         continue;
+      }
+
+      for( std::size_t evnt_idx = 0; evnt_idx < hold; evnt_idx ++ ) {
+         const evnt_data_t& evnt_data = evnt_list.front();
+
+         pt.clear();
+         pt.put( "source",   evnt_data.source );
+         pt.put( "event_id", evnt_data.event_id );
+         event_o->write( simd_sig.set( pt ));
+
+         // Config slot of the job is free with its event
+         std::size_t slot_free_num = 0;
+
+         if( slots != 0 ) {
+            std::size_t& slot_actv = slot_actv_list[evnt_data.source];
+
+            slot_actv --;
+            slot_free_num = slots - slot_actv;
+            slot_free.notify( sc_core::SC_ZERO_TIME );
+         }
+
+         for( std::size_t stat_idx = 0; stat_idx < evnt_data.status; stat_idx ++ ) {
+            pt.clear();
+            pt.put( "source", evnt_data.source );
+            pt.put( "status", stat_idx );
+
+            if( slots != 0 ) {
+               pt.put( "config_slots", slot_free_num );
+            }
+
+            busr_o->write( simd_sig.set( pt ));
+         }
+
+         evnt_list.pop_front();
+      }
+   } // for(;;)
+} // void cosim_tb_simd_c::evnt_thrd(
+
+} // namespace schd
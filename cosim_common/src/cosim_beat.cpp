@@ -0,0 +1,223 @@
+/*
+ * cosim_beat.cpp
+ *
+ *  Description: Progress heartbeat of the co-simulation
+ */
+
+#include <chrono>
+#include <sstream>
+#include <unistd.h>
+#include <boost/foreach.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include "cosim_beat.h"
+#include "cosim_adapter.h"
+#include "cosim_conv.h"
+#include "cosim_part.h"
+#include "schd_report.h"
+
+namespace schd {
+
+SC_HAS_PROCESS( schd::cosim_beat_c );
+cosim_beat_c::cosim_beat_c(
+      sc_core::sc_module_name nm )
+   : sc_core::sc_module( nm ) {
+
+   // Process registrations
+   SC_THREAD( beat_thrd ); // Periodic heartbeat
+} // cosim_beat_c::cosim_beat_c(
+
+void cosim_beat_c::init(
+      boost::optional<const boost_pt::ptree&> cosim_pref_p ) {
+   if( !cosim_pref_p.is_initialized()) {
+      return;
+   }
+
+   boost::optional<const boost_pt::ptree&> beat_pref_p = cosim_pref_p.get().get_child_optional( "heartbeat" );
+
+   if( !beat_pref_p.is_initialized()) {
+      return;
+   }
+
+   try {
+      file_name   = beat_pref_p.get().get<std::string>( "file", "" );
+      beat_period = str2time( beat_pref_p.get().get<std::string>( "period", "100us" ));
+      rate_min    = std::stod( beat_pref_p.get().get<std::string>( "rate_min", "0" ));
+      stall_time  = str2time( beat_pref_p.get().get<std::string>( "stall",  "0" ));
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::beat" ) << name() << " " << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::beat" ) << name() << " Incorrect heartbeat preferences: " << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::beat" ) << name() << " Unexpected";
+   }
+
+   if( beat_period == sc_core::SC_ZERO_TIME ) {
+      SCHD_REPORT_ERROR( "cosim::beat" ) << name() << " Incorrect period";
+   }
+
+   // Adapter front-ends of the parent process don't see the jobs in flight of the cores
+   if( stall_time != sc_core::SC_ZERO_TIME && cosim_part.enabled()) {
+      SCHD_REPORT_ERROR( "cosim::beat" ) << name() << " Stall check is not supported in parallel mode";
+   }
+
+   if( !file_name.empty()) {
+      beat_str.open( file_name, std::ios::out | std::ios::trunc );
+
+      if( !beat_str.is_open()) {
+         SCHD_REPORT_ERROR( "cosim::beat" ) << name() << " Can not open: " << file_name;
+      }
+   }
+
+   beat_en = true;
+} // void cosim_beat_c::init(
+
+bool cosim_beat_c::enabled(
+      void ) const {
+   return beat_en;
+} // bool cosim_beat_c::enabled(
+
+void cosim_beat_c::add_adapter(
+      cosim_adapter_c&                     adapter ) {
+   if( !beat_en ) {
+      return;
+   }
+
+   adpt_list.push_back( &adapter );
+} // void cosim_beat_c::add_adapter(
+
+bool cosim_beat_c::stop_get(
+      void ) const {
+   return beat_stop;
+} // bool cosim_beat_c::stop_get(
+
+std::uint64_t cosim_beat_c::rss_get(
+      void ) {
+   std::ifstream statm_str( "/proc/self/statm" );
+   std::uint64_t size_pages = 0;
+   std::uint64_t rss_pages  = 0;
+
+   if( !( statm_str >> size_pages >> rss_pages )) {
+      return 0;
+   }
+
+   return rss_pages * static_cast<std::uint64_t>( sysconf( _SC_PAGESIZE ));
+} // std::uint64_t cosim_beat_c::rss_get(
+
+void cosim_beat_c::beat_thrd(
+      void ) {
+   if( !beat_en ) {
+      return;
+   }
+
+   typedef std::chrono::steady_clock wall_clock_t;
+
+   wall_clock_t::time_point wall_start = wall_clock_t::now();
+   wall_clock_t::time_point wall_last  = wall_start;
+   sc_core::sc_time         time_last  = sc_core::sc_time_stamp();
+   std::uint64_t            dlta_last  = sc_core::sc_delta_count();
+   std::uint64_t            done_last  = 0;
+   sc_core::sc_time         done_time  = sc_core::sc_time_stamp();  // Last completion or the last time without jobs in flight
+
+   boost_pt::ptree beat_pt;
+   boost_pt::ptree adpt_list_pt;
+   boost_pt::ptree adpt_pt;
+
+   for(;;) {
+      sc_core::wait( beat_period );
+
+      // Rates over the last period
+      wall_clock_t::time_point wall_now = wall_clock_t::now();
+      std::uint64_t            dlta_now = sc_core::sc_delta_count();
+
+      double wall_sec  = std::chrono::duration<double>( wall_now - wall_last ).count();
+      double rate      = ( wall_sec > 0.0 ) ? ( sc_core::sc_time_stamp() - time_last ).to_seconds() / wall_sec : 0.0;
+      double dlta_rate = ( wall_sec > 0.0 ) ? ( dlta_now - dlta_last ) / wall_sec : 0.0;
+
+      wall_last = wall_now;
+      time_last = sc_core::sc_time_stamp();
+      dlta_last = dlta_now;
+
+      std::uint64_t done_num = 0;
+      std::size_t   actv_num = 0;
+
+      adpt_list_pt.clear();
+
+      BOOST_FOREACH( cosim_adapter_c* adpt_p, adpt_list ) {
+         adpt_pt.clear();
+         adpt_pt.put( "name",      adpt_p->name());
+         adpt_pt.put( "in_flight", adpt_p->job_actv_get());
+         adpt_pt.put( "completed", adpt_p->job_done_get());
+
+         adpt_list_pt.push_back( std::make_pair( "", adpt_pt ));
+
+         done_num += adpt_p->job_done_get();
+         actv_num += adpt_p->job_actv_get();
+      }
+
+      // Stall is the time with jobs in flight and none of them completed
+      if( done_num != done_last || actv_num == 0 ) {
+         done_last = done_num;
+         done_time = sc_core::sc_time_stamp();
+      }
+
+      beat_pt.clear();
+      beat_pt.put( "time",       sc_core::sc_time_stamp().to_seconds());
+      beat_pt.put( "wall_sec",   std::chrono::duration<double>( wall_now - wall_start ).count());
+      beat_pt.put( "rate",       rate );
+      beat_pt.put( "delta_rate", dlta_rate );
+      beat_pt.put( "in_flight",  actv_num );
+      beat_pt.put( "completed",  done_num );
+      beat_pt.put( "rss_bytes",  rss_get());
+      beat_pt.add_child( "adapters", adpt_list_pt );
+
+      if( beat_str.is_open()) {
+         boost_pt::write_json( beat_str, beat_pt, false );
+         beat_str.flush();
+      }
+      else {
+         std::ostringstream beat_ss;
+
+         boost_pt::write_json( beat_ss, beat_pt, false );
+
+         std::string beat_line = beat_ss.str();
+
+         SCHD_REPORT_INFO( "cosim::beat" ) << beat_line.substr( 0, beat_line.find_last_not_of( '\n' ) + 1 );
+      }
+
+      // Early stop. The kernel is paused, so that sc_start returns and the caller ends the simulation in order
+      if( rate_min != 0.0 && rate < rate_min ) {
+         SCHD_REPORT_INFO( "cosim::beat" ) << name() << " Simulation rate " << rate << " is below " << rate_min << ". Stopped";
+         beat_stop = true;
+         sc_core::sc_pause();
+         return;
+      }
+
+      if( stall_time != sc_core::SC_ZERO_TIME &&
+          sc_core::sc_time_stamp() - done_time >= stall_time ) {
+         SCHD_REPORT_INFO( "cosim::beat" ) << name() << " No jobs completed since " << done_time.to_string() << " with "
+                                           << actv_num << " jobs in flight. Stopped";
+         beat_stop = true;
+         sc_core::sc_pause();
+         return;
+      }
+
+      // The heartbeat alone doesn't keep the simulation running
+      if( !sc_core::sc_pending_activity()) {
+         return;
+      }
+   } // for(;;)
+} // void cosim_beat_c::beat_thrd(
+
+void cosim_beat_c::close(
+      void ) {
+   if( beat_str.is_open()) {
+      beat_str.close();
+
+      SCHD_REPORT_INFO( "cosim::beat" ) << name() << " Heartbeat: " << file_name;
+   }
+} // void cosim_beat_c::close(
+
+} // namespace schd
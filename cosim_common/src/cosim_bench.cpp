@@ -0,0 +1,525 @@
+/*
+ * cosim_bench.cpp
+ *
+ *  Description: Synthetic scalable workload and benchmark runner
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <chrono>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <boost/foreach.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include "cosim_bench.h"
+#include "cosim_sweep.h"
+#include "schd_report.h"
+
+namespace schd {
+
+// Global instance
+cosim_bench_c cosim_bench;
+
+namespace {
+   // Workload parameters and their tags in the point names
+   const char* const parm_name_list[] = {
+         "cores",    // SIMD cores
+         "blocks",   // Blocks per core
+         "threads",  // Threads of the planner
+         "clique",   // Clique width: jobs of the clique run on the different blocks of one core
+         "config",   // Config words per job
+         "length",   // Jobs per thread
+         nullptr };
+
+   const char* const parm_tag_list[] = { "c", "b", "t", "w", "l", "n" };
+
+   // Replaces %1% in the values of the template with the name
+   void name_set(
+         boost_pt::ptree&                     pt,
+         const std::string&                   name ) {
+      boost::algorithm::replace_all( pt.data(), "%1%", name );
+
+      BOOST_FOREACH( boost_pt::ptree::value_type& pt_el, pt ) {
+         name_set( pt_el.second, name );
+      }
+   } // void name_set(
+
+   // Regex which matches the name only
+   std::string name_regex(
+         const std::string&                   name ) {
+      return "^" + boost::algorithm::replace_all_copy( name, ".", "\\." ) + "$";
+   } // std::string name_regex(
+} // namespace
+
+bool cosim_bench_c::enabled(
+      void ) const {
+   return work_en;
+} // bool cosim_bench_c::enabled(
+
+int cosim_bench_c::status(
+      void ) const {
+   return ( fail_num != 0 || regr_num != 0 ) ? 1 : 0;
+} // int cosim_bench_c::status(
+
+void cosim_bench_c::pref_gen(
+      const boost_pt::ptree&               spec_pt,
+      const boost_pt::ptree&               parm_pt,
+      boost_pt::ptree&                     pref_pt ) {
+   std::size_t core_num = 0;
+   std::size_t blck_num = 0;
+   std::size_t thrd_num = 0;
+   std::size_t cliq_wid = 0;
+   std::size_t conf_len = 0;
+   std::size_t task_len = 0;
+   std::string runtime;
+
+   boost::optional<const boost_pt::ptree&> blck_list_p = spec_pt.get_child_optional( "block" );
+   boost::optional<const boost_pt::ptree&> conf_p      = spec_pt.get_child_optional( "config" );
+   boost::optional<const boost_pt::ptree&> adpt_p      = spec_pt.get_child_optional( "adapter" );
+
+   try {
+      core_num = std::stoul( parm_pt.get<std::string>( "cores"   ));
+      blck_num = std::stoul( parm_pt.get<std::string>( "blocks"  ));
+      thrd_num = std::stoul( parm_pt.get<std::string>( "threads" ));
+      cliq_wid = std::stoul( parm_pt.get<std::string>( "clique"  ));
+      conf_len = std::stoul( parm_pt.get<std::string>( "config"  ));
+      task_len = std::stoul( parm_pt.get<std::string>( "length"  ));
+      runtime  = spec_pt.get<std::string>( "runtime", "1us" );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << "Incorrect workload parameters: " << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << "Unexpected";
+   }
+
+   if( core_num == 0 || blck_num == 0 || thrd_num == 0 || cliq_wid == 0 ||
+       cliq_wid > blck_num || thrd_num % cliq_wid != 0 ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << "Incorrect workload parameters. Clique width should not exceed "
+                                          << "the number of blocks and should divide the number of threads";
+   }
+
+   if( !blck_list_p.is_initialized() || blck_list_p.get().empty()) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << "Block templates are not specified";
+   }
+
+   std::vector<const boost_pt::ptree*> blck_tmpl_list;
+
+   BOOST_FOREACH( const boost_pt::ptree::value_type& blck_el, blck_list_p.get()) {
+      if( !blck_el.first.empty() ||
+          !blck_el.second.get_optional<std::string>( "function" ).is_initialized() ||
+          !blck_el.second.get_optional<std::string>( "event"    ).is_initialized()) {
+         SCHD_REPORT_ERROR( "cosim::bench" ) << "Incorrect structure of block templates";
+      }
+
+      blck_tmpl_list.push_back( &blck_el.second );
+   }
+
+   // SIMD cores and the executors of their blocks: core.block.event
+   boost_pt::ptree simd_list_pt;
+   boost_pt::ptree exec_list_pt;
+   boost_pt::ptree exec_pt;
+
+   for( std::size_t core_idx = 0; core_idx < core_num; core_idx ++ ) {
+      std::string     core_name = "simd" + std::to_string( core_idx );
+      boost_pt::ptree core_pt;
+      boost_pt::ptree blck_list_pt;
+
+      for( std::size_t blck_idx = 0; blck_idx < blck_num; blck_idx ++ ) {
+         const boost_pt::ptree& tmpl_pt   = *blck_tmpl_list[blck_idx % blck_tmpl_list.size()];
+         std::string            blck_name = "b" + std::to_string( blck_idx );
+         boost_pt::ptree        blck_pt;
+
+         blck_pt.put( "name",     blck_name );
+         blck_pt.put( "function", tmpl_pt.get<std::string>( "function" ));
+
+         if( tmpl_pt.get_child_optional( "param" ).is_initialized()) {
+            blck_pt.add_child( "param", tmpl_pt.get_child( "param" ));
+         }
+
+         blck_list_pt.push_back( std::make_pair( "", blck_pt ));
+
+         exec_pt.clear();
+         exec_pt.put( "name", core_name + "." + blck_name + "." + tmpl_pt.get<std::string>( "event" ));
+         exec_list_pt.push_back( std::make_pair( "", exec_pt ));
+      }
+
+      core_pt.put( "name", core_name );
+
+      if( adpt_p.is_initialized()) {
+         core_pt.add_child( "adapter", adpt_p.get());
+      }
+
+      core_pt.add_child( "pref", blck_list_pt );
+      simd_list_pt.push_back( std::make_pair( "", core_pt ));
+   } // for( std::size_t core_idx = 0; core_idx < core_num; core_idx ++ )
+
+   // The threads start with the job of the SCHD core
+   exec_pt.clear();
+   exec_pt.put( "name", "bench_start" );
+   exec_list_pt.push_back( std::make_pair( "", exec_pt ));
+
+   boost_pt::ptree task_list_pt;
+   boost_pt::ptree task_pt;
+   boost_pt::ptree alt_list_pt;
+   boost_pt::ptree alt_pt;
+
+   alt_pt.put( "run", name_regex( "bench_start" ));
+   alt_pt.put_child( "use", boost_pt::ptree());
+   alt_pt.put_child( "opt", boost_pt::ptree());
+   alt_list_pt.push_back( std::make_pair( "", alt_pt ));
+
+   task_pt.put( "name", "bench_start" );
+   task_pt.add_child( "exec", alt_list_pt );
+   task_pt.put( "runtime", runtime );
+   task_list_pt.push_back( std::make_pair( "", task_pt ));
+
+   // A group of clique width threads runs the same task at each step. The task can be
+   // executed by any of the group's blocks of the core and each block receives its config
+   std::size_t grp_num = thrd_num / cliq_wid;
+
+   for( std::size_t grp_idx = 0; grp_idx < grp_num; grp_idx ++ ) {
+      std::string core_name = "simd" + std::to_string( grp_idx % core_num );
+
+      for( std::size_t step_idx = 0; step_idx < task_len; step_idx ++ ) {
+         std::string step_name = std::to_string( grp_idx ) + "_" + std::to_string( step_idx );
+
+         alt_list_pt.clear();
+
+         for( std::size_t memb_idx = 0; memb_idx < cliq_wid; memb_idx ++ ) {
+            std::size_t            blck_idx  = ( step_idx * cliq_wid + memb_idx ) % blck_num;
+            const boost_pt::ptree& tmpl_pt   = *blck_tmpl_list[blck_idx % blck_tmpl_list.size()];
+            std::string            blck_name = "b" + std::to_string( blck_idx );
+            boost_pt::ptree        conf_list_pt;
+
+            for( std::size_t conf_idx = 0; conf_idx < conf_len; conf_idx ++ ) {
+               boost_pt::ptree conf_pt = conf_p.is_initialized() ? conf_p.get() : boost_pt::ptree();
+
+               name_set( conf_pt, blck_name );
+               conf_list_pt.push_back( std::make_pair( blck_name, conf_pt )); // Config words are keyed
+            }
+
+            alt_pt.clear();
+            alt_pt.put( "run", name_regex( core_name + "." + blck_name + "." + tmpl_pt.get<std::string>( "event" )));
+            alt_pt.put_child( "use", boost_pt::ptree());
+            alt_pt.put( "opt.clique", ( cliq_wid > 1 ) ? "cq" + step_name : "" );
+            alt_pt.put_child( "opt.config", conf_list_pt );
+            alt_list_pt.push_back( std::make_pair( "", alt_pt ));
+         }
+
+         task_pt.clear();
+         task_pt.put( "name", "k" + step_name );
+         task_pt.add_child( "exec", alt_list_pt );
+         task_pt.put( "runtime", runtime );
+         task_list_pt.push_back( std::make_pair( "", task_pt ));
+      } // for( std::size_t step_idx = 0; step_idx < task_len; step_idx ++ )
+   } // for( std::size_t grp_idx = 0; grp_idx < grp_num; grp_idx ++ )
+
+   boost_pt::ptree thrd_list_pt;
+   boost_pt::ptree start_list_pt;
+
+   start_list_pt.push_back( std::make_pair( "", boost_pt::ptree( "^__start__$" )));
+
+   for( std::size_t thrd_idx = 0; thrd_idx < thrd_num; thrd_idx ++ ) {
+      std::string     thrd_name = "t" + std::to_string( thrd_idx );
+      boost_pt::ptree thrd_pt;
+      boost_pt::ptree seq_list_pt;
+      boost_pt::ptree seq_pt;
+
+      seq_pt.put( "task.run",      "bench_start" );
+      seq_pt.put( "task.param.id", thrd_name );
+      seq_list_pt.push_back( std::make_pair( "", seq_pt ));
+
+      for( std::size_t step_idx = 0; step_idx < task_len; step_idx ++ ) {
+         std::string step_name = std::to_string( thrd_idx / cliq_wid ) + "_" + std::to_string( step_idx );
+
+         seq_pt.clear();
+         seq_pt.put( "task.run",      "k" + step_name );
+         seq_pt.put( "task.param.id", thrd_name + "_" + std::to_string( step_idx ));
+         seq_list_pt.push_back( std::make_pair( "", seq_pt ));
+      }
+
+      thrd_pt.put( "name",     thrd_name );
+      thrd_pt.put( "priority", "1.0" );
+      thrd_pt.add_child( "start",    start_list_pt );
+      thrd_pt.add_child( "sequence", seq_list_pt );
+      thrd_list_pt.push_back( std::make_pair( "", thrd_pt ));
+   } // for( std::size_t thrd_idx = 0; thrd_idx < thrd_num; thrd_idx ++ )
+
+   // Generated sections replace the ones of the base preferences
+   pref_pt.put_child( "simd",      simd_list_pt );
+   pref_pt.put_child( "executors", exec_list_pt );
+   pref_pt.put_child( "tasks",     task_list_pt );
+   pref_pt.put_child( "threads",   thrd_list_pt );
+
+   if( spec_pt.get_optional<std::string>( "finish" ).is_initialized()) {
+      pref_pt.put( "time.finish", spec_pt.get<std::string>( "finish" ));
+   }
+} // void cosim_bench_c::pref_gen(
+
+void cosim_bench_c::point_add(
+      const boost_pt::ptree&               spec_pt ) {
+   boost::optional<const boost_pt::ptree&> grid_p = spec_pt.get_child_optional( "grid" );
+
+   // Values of the parameters. Parameters which are not in the grid are 1
+   std::vector<std::vector<std::string>> val_list;
+   std::size_t point_num = 1;
+
+   for( std::size_t parm_idx = 0; parm_name_list[parm_idx] != nullptr; parm_idx ++ ) {
+      val_list.push_back( std::vector<std::string>());
+
+      boost::optional<const boost_pt::ptree&> parm_p = grid_p.is_initialized() ?
+            grid_p.get().get_child_optional( parm_name_list[parm_idx] ) :
+            boost::optional<const boost_pt::ptree&>();
+
+      if( parm_p.is_initialized()) {
+         BOOST_FOREACH( const boost_pt::ptree::value_type& val_el, parm_p.get()) {
+            val_list.back().push_back( val_el.second.data());
+         }
+
+         if( val_list.back().empty()) {
+            SCHD_REPORT_ERROR( "cosim::bench" ) << "Incorrect grid values: " << parm_name_list[parm_idx];
+         }
+      }
+      else {
+         val_list.back().push_back( "1" );
+      }
+
+      point_num *= val_list.back().size();
+   }
+
+   for( std::size_t point_idx = 0; point_idx < point_num; point_idx ++ ) {
+      point_list.push_back( point_data_t());
+
+      std::size_t val_idx = point_idx;
+
+      for( std::size_t parm_idx = 0; parm_idx < val_list.size(); parm_idx ++ ) {
+         const std::string& val = val_list[parm_idx][val_idx % val_list[parm_idx].size()];
+         val_idx /= val_list[parm_idx].size();
+
+         point_list.back().parm_pt.put( parm_name_list[parm_idx], val );
+         point_list.back().name += std::string( parm_idx == 0 ? "" : "_" ) +
+                                   parm_tag_list[parm_idx] + val;
+      }
+   }
+} // void cosim_bench_c::point_add(
+
+bool cosim_bench_c::run(
+      const std::string&                   spec_file,
+      std::string&                         pref_file ) {
+   boost_pt::ptree spec_pt;
+   boost_pt::ptree base_pt;
+   std::string     base_file;
+
+   try {
+      boost_pt::read_json( spec_file, spec_pt );
+
+      // Base preferences file is relative to the specification
+      base_file = spec_pt.get<std::string>( "base" );
+
+      std::size_t dir_pos = spec_file.rfind( '/' );
+
+      if( base_file.compare( 0, 1, "/" ) != 0 && dir_pos != std::string::npos ) {
+         base_file = spec_file.substr( 0, dir_pos + 1 ) + base_file;
+      }
+
+      boost_pt::read_json( base_file, base_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << "Unexpected";
+   }
+
+   point_add( spec_pt );
+
+   std::string res_file = spec_pt.get<std::string>( "results",  "bench_results.json" );
+   std::string bln_file = spec_pt.get<std::string>( "baseline", "" );
+
+   SCHD_REPORT_INFO( "cosim::bench" ) << "Points: " << point_list.size();
+
+   // One run at a time, so the runs do not compete for the host
+   BOOST_FOREACH( point_data_t& point_el, point_list ) {
+      std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+      int pid = cosim_sweep_c::work_fork( point_el.name );
+
+      if( pid == 0 ) { // Worker
+         pref_gen( spec_pt, point_el.parm_pt, base_pt );
+
+         cosim_sweep_c::work_pref( base_pt, pref_file );
+
+         work_en = true;
+
+         return true;
+      }
+
+      // Peak RSS of the worker is reported with its exit status
+      struct rusage usage;
+      int           status = 0;
+
+      while( wait4( pid, &status, 0, &usage ) < 0 ) {
+         if( errno != EINTR ) {
+            SCHD_REPORT_ERROR( "cosim::bench" ) << "Wait error: " << std::strerror( errno );
+         }
+      }
+
+      point_el.status   = WIFEXITED( status ) ? WEXITSTATUS( status ) : -1;
+      point_el.wall_sec = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_time ).count();
+      point_el.rss_kb   = usage.ru_maxrss;
+
+      SCHD_REPORT_INFO( "cosim::bench" ) << "Done: " << point_el.name
+                                         << " Status: " << point_el.status
+                                         << " Wall: " << point_el.wall_sec << "s"
+                                         << " RSS: " << point_el.rss_kb << "KB";
+   } // BOOST_FOREACH( point_data_t& point_el, point_list )
+
+   // Gather the results
+   boost_pt::ptree res_pt;
+   boost_pt::ptree run_list_pt;
+
+   BOOST_FOREACH( const point_data_t& point_el, point_list ) {
+      boost_pt::ptree run_pt;
+      boost_pt::ptree summ_pt;
+      double          sim_sec = 0.0;
+
+      try {
+         boost_pt::read_json( point_el.name + "/" + cosim_sweep_c::summ_name, summ_pt );
+         sim_sec = summ_pt.get<double>( "end_sec", 0.0 );
+      }
+      catch( const boost_pt::ptree_error& err ) { // Worker failed before the end of simulation
+         summ_pt.clear();
+      }
+
+      run_pt.put( "name",        point_el.name );
+      run_pt.add_child( "param", point_el.parm_pt );
+      run_pt.put( "status",      point_el.status );
+      run_pt.put( "wall_sec",    point_el.wall_sec );
+      run_pt.put( "sim_sec",     sim_sec );
+      run_pt.put( "sim_rate",    ( point_el.wall_sec > 0.0 ) ? sim_sec / point_el.wall_sec : 0.0 );
+      run_pt.put( "rss_kb",      point_el.rss_kb );
+      run_pt.put( "delta_count", summ_pt.get<std::string>( "delta_count", "" ));
+
+      if( point_el.status != 0 ) {
+         fail_num ++;
+      }
+
+      SCHD_REPORT_INFO( "cosim::bench" ) << point_el.name
+                                         << " Sim/wall: " << run_pt.get<std::string>( "sim_rate" )
+                                         << " RSS: " << point_el.rss_kb << "KB";
+
+      run_list_pt.push_back( std::make_pair( "", run_pt ));
+   } // BOOST_FOREACH( const point_data_t& point_el, point_list )
+
+   res_pt.put( "spec",   spec_file );
+   res_pt.put( "base",   base_file );
+   res_pt.put( "failed", fail_num );
+   res_pt.add_child( "runs", run_list_pt );
+
+   if( !bln_file.empty()) {
+      res_pt.put( "tolerance", spec_pt.get<std::string>( "tolerance", "0.1" ));
+      base_check( bln_file, res_pt );
+   }
+
+   try {
+      boost_pt::write_json( res_file, res_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << err.what();
+   }
+
+   SCHD_REPORT_INFO( "cosim::bench" ) << "Results: " << res_file
+                                      << " Failed: " << fail_num
+                                      << " Regressions: " << regr_num;
+
+   return false;
+} // bool cosim_bench_c::run(
+
+void cosim_bench_c::base_check(
+      const std::string&                   base_file,
+      boost_pt::ptree&                     res_pt ) {
+   boost_pt::ptree bln_pt;
+   double          tol = 0.0;
+
+   try {
+      boost_pt::read_json( base_file, bln_pt );
+      tol = std::stod( res_pt.get<std::string>( "tolerance" ));
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << "Incorrect tolerance: " << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::bench" ) << "Unexpected";
+   }
+
+   res_pt.put( "baseline", base_file );
+
+   BOOST_FOREACH( boost_pt::ptree::value_type& run_el, res_pt.get_child( "runs" )) {
+      boost_pt::ptree& run_pt = run_el.second;
+
+      boost::optional<const boost_pt::ptree&> bln_run_p;
+
+      BOOST_FOREACH( const boost_pt::ptree::value_type& bln_el, bln_pt.get_child( "runs", boost_pt::ptree())) {
+         if( bln_el.second.get<std::string>( "name", "" ) == run_pt.get<std::string>( "name" )) {
+            bln_run_p = bln_el.second;
+            break;
+         }
+      }
+
+      if( !bln_run_p.is_initialized()) { // New point
+         continue;
+      }
+
+      double rate     = run_pt.get<double>( "sim_rate" );
+      double bln_rate = bln_run_p.get().get<double>( "sim_rate", 0.0 );
+      long   rss      = run_pt.get<long>( "rss_kb" );
+      long   bln_rss  = bln_run_p.get().get<long>( "rss_kb", 0 );
+      std::string regr;
+
+      if( bln_rate > 0.0 && rate < bln_rate * ( 1.0 - tol )) {
+         regr = "sim_rate";
+      }
+      else if( bln_rss > 0 && rss > bln_rss * ( 1.0 + tol )) {
+         regr = "rss_kb";
+      }
+
+      run_pt.put( "baseline_rate",   bln_rate );
+      run_pt.put( "baseline_rss_kb", bln_rss );
+      run_pt.put( "regression",      regr );
+
+      if( !regr.empty()) {
+         regr_num ++;
+
+         SCHD_REPORT_INFO( "cosim::bench" ) << "Regression: " << run_pt.get<std::string>( "name" )
+                                            << " Sim/wall: " << rate << " (" << bln_rate << ")"
+                                            << " RSS: " << rss << "KB (" << bln_rss << "KB)";
+      }
+   } // BOOST_FOREACH( boost_pt::ptree::value_type& run_el, res_pt.get_child( "runs" ))
+
+   res_pt.put( "regressions", regr_num );
+} // void cosim_bench_c::base_check(
+
+void cosim_bench_c::summary(
+      void ) {
+   if( !work_en ) {
+      return;
+   }
+
+   cosim_sweep_c::summ_write();
+} // void cosim_bench_c::summary(
+
+} // namespace schd
@@ -0,0 +1,427 @@
+/*
+ * cosim_ckpt.cpp
+ *
+ *  Description: Checkpoint and restore of the simulation
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <iostream>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <boost/foreach.hpp>
+#include "cosim_ckpt.h"
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+// Global instance
+cosim_ckpt_c cosim_ckpt;
+
+void cosim_ckpt_c::init(
+      boost::optional<const boost_pt::ptree&> cosim_pref_p ) {
+   if( !cosim_pref_p.is_initialized()) {
+      return;
+   }
+
+   boost::optional<const boost_pt::ptree&> ckpt_pref_p = cosim_pref_p.get().get_child_optional( "checkpoint" );
+
+   if( !ckpt_pref_p.is_initialized()) {
+      return;
+   }
+
+   try {
+      ckpt_time = str2time( ckpt_pref_p.get().get<std::string>( "time" ));
+      sock_name = ckpt_pref_p.get().get<std::string>( "socket", "cosim.ckpt" );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::ckpt" ) << err.what();
+   }
+
+   if( sock_name.size() >= sizeof( sockaddr_un::sun_path )) {
+      SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Socket name is too long: " << sock_name;
+   }
+
+   ckpt_en = true;
+} // void cosim_ckpt_c::init(
+
+bool cosim_ckpt_c::enabled(
+      void ) const {
+   return ckpt_en;
+} // bool cosim_ckpt_c::enabled(
+
+const sc_core::sc_time& cosim_ckpt_c::time_get(
+      void ) const {
+   return ckpt_time;
+} // const sc_core::sc_time& cosim_ckpt_c::time_get(
+
+void cosim_ckpt_c::save(
+      void ) {
+   // Buffered output would be written by the running process and by each restored copy
+   std::cout.flush();
+   std::cerr.flush();
+   std::fflush( nullptr );
+
+   int pid = fork();
+
+   if( pid < 0 ) {
+      SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Fork error: " << std::strerror( errno );
+   }
+   else if( pid > 0 ) { // Running process continues
+      SCHD_REPORT_INFO( "cosim::ckpt" ) << "Checkpoint at " << sc_core::sc_time_stamp().to_string()
+                                        << " Socket: " << sock_name;
+      return;
+   }
+
+   // Snapshot server. The running process keeps writing to the output files after the checkpoint
+   out_save();
+
+   // Detach from the terminal of the running process
+   setsid();
+
+   int null_fd = open( "/dev/null", O_RDWR );
+
+   if( null_fd >= 0 ) {
+      dup2( null_fd, STDIN_FILENO  );
+      dup2( null_fd, STDOUT_FILENO );
+      dup2( null_fd, STDERR_FILENO );
+      close( null_fd );
+   }
+
+   serve(); // Returns in the restored copy only
+} // void cosim_ckpt_c::save(
+
+void cosim_ckpt_c::serve(
+      void ) {
+   int sock_fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+
+   sockaddr_un sock_addr;
+   std::memset( &sock_addr, 0, sizeof( sock_addr ));
+   sock_addr.sun_family = AF_UNIX;
+   std::strncpy( sock_addr.sun_path, sock_name.c_str(), sizeof( sock_addr.sun_path ) - 1 );
+
+   unlink( sock_name.c_str());
+
+   if( sock_fd < 0 ||
+       bind( sock_fd, reinterpret_cast<sockaddr*>( &sock_addr ), sizeof( sock_addr )) != 0 ||
+       listen( sock_fd, 1 ) != 0 ) {
+      _exit( 1 );
+   }
+
+   // Restore requests are served one at a time: the copy reports its exit status to the client
+   for(;;) {
+      int conn_fd = accept( sock_fd, nullptr, nullptr );
+
+      if( conn_fd < 0 ) {
+         if( errno == EINTR ) {
+            continue;
+         }
+
+         break;
+      }
+
+      // Command with stdin, stdout, stderr and working directory of the client
+      char    cmd = 0;
+      int     fd_list[4] = { -1, -1, -1, -1 };
+      char    ctrl_buf[CMSG_SPACE( sizeof( fd_list ))];
+      iovec   io_vec  = { &cmd, 1 };
+      msghdr  msg_hdr;
+
+      std::memset( &msg_hdr, 0, sizeof( msg_hdr ));
+      msg_hdr.msg_iov        = &io_vec;
+      msg_hdr.msg_iovlen     = 1;
+      msg_hdr.msg_control    = ctrl_buf;
+      msg_hdr.msg_controllen = sizeof( ctrl_buf );
+
+      if( recvmsg( conn_fd, &msg_hdr, 0 ) != 1 ) {
+         close( conn_fd );
+         continue;
+      }
+
+      cmsghdr* cmsg_p = CMSG_FIRSTHDR( &msg_hdr );
+
+      if( cmsg_p != nullptr &&
+          cmsg_p->cmsg_level == SOL_SOCKET &&
+          cmsg_p->cmsg_type  == SCM_RIGHTS &&
+          cmsg_p->cmsg_len   == CMSG_LEN( sizeof( fd_list ))) {
+         std::memcpy( fd_list, CMSG_DATA( cmsg_p ), sizeof( fd_list ));
+      }
+
+      if( cmd == cmd_stop ) {
+         close( conn_fd );
+         break;
+      }
+      else if( cmd != cmd_restore || fd_list[3] < 0 ) {
+         close( conn_fd );
+         continue;
+      }
+
+      int pid = fork();
+
+      if( pid == 0 ) { // Restored copy
+         close( sock_fd );
+         close( conn_fd );
+
+         dup2( fd_list[0], STDIN_FILENO  );
+         dup2( fd_list[1], STDOUT_FILENO );
+         dup2( fd_list[2], STDERR_FILENO );
+
+         if( fchdir( fd_list[3] ) != 0 ) {
+            _exit( 1 );
+         }
+
+         for( int fd_idx = 0; fd_idx < 4; fd_idx ++ ) {
+            close( fd_list[fd_idx] );
+         }
+
+         out_restore();
+
+         SCHD_REPORT_INFO( "cosim::ckpt" ) << "Restored at " << sc_core::sc_time_stamp().to_string();
+
+         return;
+      }
+
+      int status = 1;
+
+      if( pid > 0 ) {
+         while( waitpid( pid, &status, 0 ) < 0 && errno == EINTR ) {
+         }
+
+         status = WIFEXITED( status ) ? WEXITSTATUS( status ) : 1;
+      }
+
+      for( int fd_idx = 0; fd_idx < 4; fd_idx ++ ) {
+         close( fd_list[fd_idx] );
+      }
+
+      if( write( conn_fd, &status, sizeof( status )) != sizeof( status )) {
+         // Client is gone
+      }
+
+      close( conn_fd );
+   } // for(;;)
+
+   close( sock_fd );
+   unlink( sock_name.c_str());
+
+   _exit( 0 );
+} // void cosim_ckpt_c::serve(
+
+void cosim_ckpt_c::out_save(
+      void ) {
+   char cwd_buf[PATH_MAX];
+
+   if( getcwd( cwd_buf, sizeof( cwd_buf )) == nullptr ) {
+      SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Working directory error: " << std::strerror( errno );
+   }
+
+   std::string cwd_name = std::string( cwd_buf ) + "/";
+   DIR*        dir_p    = opendir( "/proc/self/fd" );
+
+   if( dir_p == nullptr ) {
+      SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Can not list the open files: " << std::strerror( errno );
+   }
+
+   // Regular files open for writing
+   for( dirent* ent_p = readdir( dir_p ); ent_p != nullptr; ent_p = readdir( dir_p )) {
+      char* end_p = nullptr;
+      long  fd    = std::strtol( ent_p->d_name, &end_p, 10 );
+
+      if( end_p == ent_p->d_name || *end_p != '\0' ||
+          fd <= STDERR_FILENO || fd == dirfd( dir_p )) {
+         continue;
+      }
+
+      struct stat fd_stat;
+      int         flags = fcntl( fd, F_GETFL );
+
+      if( flags < 0 || ( flags & O_ACCMODE ) == O_RDONLY ||
+          fstat( fd, &fd_stat ) != 0 || !S_ISREG( fd_stat.st_mode )) {
+         continue;
+      }
+
+      char    link_buf[PATH_MAX];
+      ssize_t link_len = readlink(( std::string( "/proc/self/fd/" ) + ent_p->d_name ).c_str(),
+                                  link_buf, sizeof( link_buf ) - 1 );
+
+      if( link_len <= 0 || link_buf[0] != '/' ) { // Not a file of the file system
+         continue;
+      }
+
+      std::string file_name( link_buf, link_len );
+
+      out_list.push_back( out_data_t());
+      out_list.back().fd    = fd;
+      out_list.back().pos   = lseek( fd, 0, SEEK_CUR );
+      out_list.back().flags = flags & O_APPEND;
+
+      // Files outside of the working directory are continued next to the client under their name
+      out_list.back().name  = ( file_name.compare( 0, cwd_name.size(), cwd_name ) == 0 ) ?
+            file_name.substr( cwd_name.size()) :
+            file_name.substr( file_name.rfind( '/' ) + 1 );
+   }
+
+   closedir( dir_p );
+
+   // Contents at the checkpoint are kept in the unlinked temporary files
+   BOOST_FOREACH( out_data_t& out_el, out_list ) {
+      std::string       temp_name = std::string( P_tmpdir ) + "/cosim_ckpt_XXXXXX";
+      std::vector<char> temp_buf( temp_name.begin(), temp_name.end());
+
+      temp_buf.push_back( '\0' );
+
+      out_el.copy_fd = mkstemp( temp_buf.data());
+
+      if( out_el.copy_fd < 0 ) {
+         SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Can not create the copy of: " << out_el.name << " " << std::strerror( errno );
+      }
+
+      unlink( temp_buf.data());
+
+      // Output descriptor may be write-only
+      int file_fd = open(( "/proc/self/fd/" + std::to_string( out_el.fd )).c_str(), O_RDONLY );
+
+      if( file_fd < 0 ||
+          !file_copy( file_fd, out_el.copy_fd )) {
+         SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Can not copy: " << out_el.name << " " << std::strerror( errno );
+      }
+
+      close( file_fd );
+   }
+} // void cosim_ckpt_c::out_save(
+
+void cosim_ckpt_c::out_restore(
+      void ) {
+   BOOST_FOREACH( out_data_t& out_el, out_list ) {
+      int file_fd = open( out_el.name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | out_el.flags, 0644 );
+
+      if( file_fd < 0 ||
+          !file_copy( out_el.copy_fd, file_fd ) ||
+          dup2( file_fd, out_el.fd ) < 0 ||
+          lseek( out_el.fd, out_el.pos, SEEK_SET ) < 0 ) {
+         SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Can not restore: " << out_el.name << " " << std::strerror( errno );
+      }
+
+      close( file_fd );
+      close( out_el.copy_fd );
+   }
+} // void cosim_ckpt_c::out_restore(
+
+bool cosim_ckpt_c::file_copy(
+      int                                  src_fd,
+      int                                  dst_fd ) {
+   char  copy_buf[65536];
+   off_t copy_pos = 0;
+
+   for(;;) {
+      ssize_t rd_len = pread( src_fd, copy_buf, sizeof( copy_buf ), copy_pos );
+
+      if( rd_len < 0 && errno == EINTR ) {
+         continue;
+      }
+      else if( rd_len <= 0 ) {
+         return rd_len == 0;
+      }
+
+      for( ssize_t wr_pos = 0; wr_pos < rd_len; ) {
+         ssize_t wr_len = pwrite( dst_fd, copy_buf + wr_pos, rd_len - wr_pos, copy_pos + wr_pos );
+
+         if( wr_len < 0 && errno == EINTR ) {
+            continue;
+         }
+         else if( wr_len <= 0 ) {
+            return false;
+         }
+
+         wr_pos += wr_len;
+      }
+
+      copy_pos += rd_len;
+   }
+} // bool cosim_ckpt_c::file_copy(
+
+int cosim_ckpt_c::connect_sock(
+      const std::string&                   sock_name ) {
+   int sock_fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+
+   sockaddr_un sock_addr;
+   std::memset( &sock_addr, 0, sizeof( sock_addr ));
+   sock_addr.sun_family = AF_UNIX;
+   std::strncpy( sock_addr.sun_path, sock_name.c_str(), sizeof( sock_addr.sun_path ) - 1 );
+
+   if( sock_fd < 0 ||
+       connect( sock_fd, reinterpret_cast<sockaddr*>( &sock_addr ), sizeof( sock_addr )) != 0 ) {
+      SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Checkpoint is not available: " << sock_name;
+   }
+
+   return sock_fd;
+} // int cosim_ckpt_c::connect_sock(
+
+int cosim_ckpt_c::restore(
+      const std::string&                   sock_name ) {
+   int  sock_fd    = connect_sock( sock_name );
+   char cmd        = cmd_restore;
+   int  fd_list[4] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO, open( ".", O_RDONLY | O_DIRECTORY ) };
+   char ctrl_buf[CMSG_SPACE( sizeof( fd_list ))];
+   iovec  io_vec = { &cmd, 1 };
+   msghdr msg_hdr;
+
+   std::memset( &msg_hdr, 0, sizeof( msg_hdr ));
+   std::memset( ctrl_buf, 0, sizeof( ctrl_buf ));
+   msg_hdr.msg_iov        = &io_vec;
+   msg_hdr.msg_iovlen     = 1;
+   msg_hdr.msg_control    = ctrl_buf;
+   msg_hdr.msg_controllen = sizeof( ctrl_buf );
+
+   cmsghdr* cmsg_p = CMSG_FIRSTHDR( &msg_hdr );
+   cmsg_p->cmsg_level = SOL_SOCKET;
+   cmsg_p->cmsg_type  = SCM_RIGHTS;
+   cmsg_p->cmsg_len   = CMSG_LEN( sizeof( fd_list ));
+   std::memcpy( CMSG_DATA( cmsg_p ), fd_list, sizeof( fd_list ));
+
+   std::cout.flush();
+   std::cerr.flush();
+
+   if( fd_list[3] < 0 ||
+       sendmsg( sock_fd, &msg_hdr, 0 ) != 1 ) {
+      SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Restore error: " << std::strerror( errno );
+   }
+
+   close( fd_list[3] );
+
+   // Wait for the end of the restored simulation
+   int status = 1;
+
+   if( read( sock_fd, &status, sizeof( status )) != sizeof( status )) {
+      status = 1;
+   }
+
+   close( sock_fd );
+
+   return status;
+} // int cosim_ckpt_c::restore(
+
+int cosim_ckpt_c::stop(
+      const std::string&                   sock_name ) {
+   int  sock_fd = connect_sock( sock_name );
+   char cmd     = cmd_stop;
+
+   if( write( sock_fd, &cmd, 1 ) != 1 ) {
+      SCHD_REPORT_ERROR( "cosim::ckpt" ) << "Stop error: " << std::strerror( errno );
+   }
+
+   close( sock_fd );
+
+   return 0;
+} // int cosim_ckpt_c::stop(
+
+} // namespace schd
@@ -0,0 +1,139 @@
+/*
+ * cosim_conv.cpp
+ *
+ *  Description: Conversion routines for co-simulation
+ */
+
+#include <cmath>
+#include <boost/foreach.hpp>
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+sc_core::sc_time str2time(
+      const std::string& str ) {
+   std::size_t unit_pos = 0;
+   double      num      = 0.0;
+
+   try {
+      num = std::stod( str, &unit_pos );
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::conv" ) << "Incorrect time: " << str;
+   }
+
+   std::string unit = str.substr( unit_pos );
+
+   if(      unit == "s"  ) return sc_core::sc_time( num, sc_core::SC_SEC );
+   else if( unit == "ms" ) return sc_core::sc_time( num, sc_core::SC_MS  );
+   else if( unit == "us" ) return sc_core::sc_time( num, sc_core::SC_US  );
+   else if( unit == "ns" ) return sc_core::sc_time( num, sc_core::SC_NS  );
+   else if( unit == "ps" ) return sc_core::sc_time( num, sc_core::SC_PS  );
+   else if( unit == "fs" ) return sc_core::sc_time( num, sc_core::SC_FS  );
+   else if( unit.empty() && num == 0.0 ) return sc_core::SC_ZERO_TIME;
+
+   SCHD_REPORT_ERROR( "cosim::conv" ) << "Incorrect time units: " << str;
+
+   return sc_core::SC_ZERO_TIME;
+} // sc_core::sc_time str2time(
+
+sc_core::sc_time val2time(
+      std::uint64_t      val ) {
+   return sc_core::sc_get_time_resolution() * static_cast<double>( val );
+} // sc_core::sc_time val2time(
+
+std::uint64_t time2val(
+      const sc_core::sc_time& time ) {
+   return static_cast<std::uint64_t>( std::llround( time / sc_core::sc_get_time_resolution()));
+} // std::uint64_t time2val(
+
+void uint2bin(
+      std::uint64_t      val,
+      std::string&       bin ) {
+   do {
+      char byte = static_cast<char>( val & 0x7F );
+      val >>= 7;
+
+      bin.push_back( val != 0 ? static_cast<char>( byte | 0x80 ) : byte );
+   } while( val != 0 );
+} // void uint2bin(
+
+bool bin2uint(
+      const char*&       pos,
+      const char*        end,
+      std::uint64_t&     val ) {
+   unsigned int shift = 0;
+
+   val = 0;
+
+   while( pos != end && shift < 64 ) {
+      unsigned char byte = static_cast<unsigned char>( *pos ++ );
+
+      val |= static_cast<std::uint64_t>( byte & 0x7F ) << shift;
+      shift += 7;
+
+      if(( byte & 0x80 ) == 0 ) {
+         return true;
+      }
+   }
+
+   return false;
+} // bool bin2uint(
+
+std::string& pt2bin(
+      const boost_pt::ptree& pt,
+      std::string&           bin ) {
+   // Data, number of children, then key and subtree of each child
+   uint2bin( pt.data().size(), bin );
+   bin.append( pt.data() );
+   uint2bin( pt.size(), bin );
+
+   BOOST_FOREACH( const boost_pt::ptree::value_type& pt_el, pt ) {
+      uint2bin( pt_el.first.size(), bin );
+      bin.append( pt_el.first );
+      pt2bin( pt_el.second, bin );
+   }
+
+   return bin;
+} // std::string& pt2bin(
+
+bool bin2pt(
+      const char*&           pos,
+      const char*            end,
+      boost_pt::ptree&       pt ) {
+   std::uint64_t size;
+
+   pt.clear();
+
+   if( !bin2uint( pos, end, size ) || static_cast<std::uint64_t>( end - pos ) < size ) {
+      return false;
+   }
+
+   pt.data().assign( pos, size );
+   pos += size;
+
+   std::uint64_t child_num;
+
+   if( !bin2uint( pos, end, child_num )) {
+      return false;
+   }
+
+   for( std::uint64_t child_idx = 0; child_idx < child_num; child_idx ++ ) {
+      if( !bin2uint( pos, end, size ) || static_cast<std::uint64_t>( end - pos ) < size ) {
+         return false;
+      }
+
+      boost_pt::ptree::iterator child_it = pt.push_back(
+            std::make_pair( std::string( pos, size ), boost_pt::ptree()));
+      pos += size;
+
+      if( !bin2pt( pos, end, child_it->second )) {
+         return false;
+      }
+   }
+
+   return true;
+} // bool bin2pt(
+
+} // namespace schd
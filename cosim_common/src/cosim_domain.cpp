@@ -0,0 +1,159 @@
+/*
+ * cosim_domain.cpp
+ *
+ *  Description: Core->planner mux of a planner domain
+ */
+
+#include <boost/foreach.hpp>
+#include "cosim_domain.h"
+#include "schd_conv_ptree.h"
+#include "schd_assert.h"
+#include "schd_report.h"
+
+namespace schd {
+
+SC_HAS_PROCESS( schd::cosim_domain_c );
+cosim_domain_c::cosim_domain_c(
+      sc_core::sc_module_name nm )
+   : sc_core::sc_module( nm )
+   , vi(     "vi"     )
+   , plan_o( "plan_o" )
+   , fwd_o(  "fwd_o"  )
+   , fwd_eo( "fwd_eo" )
+   , chn_fwd( "chn_fwd", chn_fwd_size ) {
+
+   // Process registrations
+   SC_THREAD( dom_thrd ); // Thread for data forwarding
+} // cosim_domain_c::cosim_domain_c(
+
+void cosim_domain_c::init(
+      std::size_t                          core_num,
+      const std::vector<std::string>&      fwd_mask_list ) {
+   fwd_list.resize( fwd_mask_list.size());
+
+   for( std::size_t fwd_idx = 0; fwd_idx < fwd_mask_list.size(); fwd_idx ++ ) {
+      if( fwd_mask_list[fwd_idx].empty()) {
+         continue;
+      }
+
+      try {
+         fwd_list[fwd_idx].mask    = boost::regex( fwd_mask_list[fwd_idx] );
+         fwd_list[fwd_idx].mask_en = true;
+      }
+      catch( const std::exception& err ) {
+         SCHD_REPORT_ERROR( "cosim::domain" ) << name() << " Incorrect mask: " << fwd_mask_list[fwd_idx] << " " << err.what();
+      }
+   }
+
+   vi.init( core_num );
+   fwd_o.init( fwd_mask_list.size());
+
+   // Other domains write the forwarded completions into fwd_eo
+   fwd_eo.bind( chn_fwd );
+} // void cosim_domain_c::init(
+
+const std::vector<std::size_t>& cosim_domain_c::fwd_find(
+      const std::string& src ) {
+   std::unordered_map<std::string, std::vector<std::size_t>>::iterator fwd_it = fwd_idx_list.find( src );
+
+   // Masks are matched once for each executor
+   if( fwd_it == fwd_idx_list.end()) {
+      std::vector<std::size_t> idx_list;
+
+      for( std::size_t fwd_idx = 0; fwd_idx < fwd_list.size(); fwd_idx ++ ) {
+         if( fwd_list[fwd_idx].mask_en &&
+             boost::regex_match( src, fwd_list[fwd_idx].mask )) {
+            idx_list.push_back( fwd_idx );
+         }
+      }
+
+      fwd_it = fwd_idx_list.insert({ src, idx_list }).first;
+   }
+
+   return fwd_it->second;
+} // const std::vector<std::size_t>& cosim_domain_c::fwd_find(
+
+void cosim_domain_c::dom_thrd(
+      void ) {
+   schd::schd_sig_ptree_c pt_sig;
+
+   sc_core::sc_event_or_list in_evnt_list;    // New completions
+   sc_core::sc_event_or_list stage_evnt_list; // New completions or space in the muxes of the other domains
+
+   for( std::size_t vi_idx = 0; vi_idx < vi.size(); vi_idx ++ ) {
+      in_evnt_list    |= vi[vi_idx]->data_written_event();
+      stage_evnt_list |= vi[vi_idx]->data_written_event();
+   }
+
+   in_evnt_list    |= chn_fwd.data_written_event();
+   stage_evnt_list |= chn_fwd.data_written_event();
+
+   for( std::size_t fwd_idx = 0; fwd_idx < fwd_o.size(); fwd_idx ++ ) {
+      stage_evnt_list |= fwd_o[fwd_idx]->data_read_event();
+   }
+
+   for(;;) {
+      bool in_idle    = true;
+      bool stage_idle = true;
+
+      // Forwarding doesn't block. The planner of this domain is not held back by the other domains
+      for( std::size_t fwd_idx = 0; fwd_idx < fwd_list.size(); fwd_idx ++ ) {
+         std::deque<schd::schd_sig_ptree_c>& stage = fwd_list[fwd_idx].stage;
+
+         while( !stage.empty() &&
+                fwd_o[fwd_idx]->nb_write( stage.front())) {
+            stage.pop_front();
+         }
+
+         stage_idle = stage_idle && stage.empty();
+      }
+
+      for( std::size_t vi_idx = 0; vi_idx < vi.size(); vi_idx ++ ) {
+         while( vi[vi_idx]->nb_read( pt_sig )) {
+            in_idle = false;
+
+            const boost_pt::ptree& pt = pt_sig.get();
+
+            boost_pt::ptree::const_assoc_iterator src_it = pt.find( "src" );
+
+            if( src_it == pt.not_found()) {
+               std::string pt_str;
+
+               SCHD_REPORT_ERROR( "cosim::domain" ) << name()
+                                                    << " Incorrect data format: "
+                                                    << pt2str( pt, pt_str );
+            }
+
+            BOOST_FOREACH( const std::size_t fwd_idx, fwd_find( src_it->second.data())) {
+               std::deque<schd::schd_sig_ptree_c>& stage = fwd_list[fwd_idx].stage;
+
+               if( !stage.empty() ||
+                   !fwd_o[fwd_idx]->nb_write( pt_sig )) {
+                  stage.push_back( pt_sig );
+                  stage_idle = false;
+               }
+            }
+
+            plan_o->write( pt_sig );
+         }
+      }
+
+      // Completions imported from the other domains
+      while( chn_fwd.nb_read( pt_sig )) {
+         in_idle = false;
+
+         plan_o->write( pt_sig );
+      }
+
+      if( in_idle ) {
+         if( stage_idle ) {
+            sc_core::wait( in_evnt_list );
+         }
+         else {
+            sc_core::wait( stage_evnt_list );
+         }
+      }
+   } // for(;;)
+} // void cosim_domain_c::dom_thrd(
+
+} // namespace schd
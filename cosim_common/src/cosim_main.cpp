@@ -1,7 +1,22 @@
+#include <unordered_set>
+#include <unordered_map>
 #include <boost/foreach.hpp>
+#include <boost/algorithm/string/replace.hpp>
 #include "schd_common.h"
 #include "simd_common.h"
 #include "cosim_adapter.h"
+#include "cosim_router.h"
+#include "cosim_domain.h"
+#include "cosim_part.h"
+#include "cosim_sweep.h"
+#include "cosim_bench.h"
+#include "cosim_ckpt.h"
+#include "cosim_pref.h"
+#include "cosim_stream.h"
+#include "cosim_trace.h"
+#include "cosim_rec.h"
+#include "cosim_stat.h"
+#include "cosim_beat.h"
 #include "schd_conv_ptree.h"
 
 namespace schd {
@@ -10,61 +25,367 @@ namespace schd {
       std::size_t                              idx;
       std::string                              name;
       boost::optional<const boost_pt::ptree&>  core_pref_p;
+      boost::optional<const boost_pt::ptree&>  adpt_pref_p;
       boost::optional<schd::schd_core_c &>     schd_core_p;
       boost::optional<schd::cosim_adapter_c &> adapter_p;
       boost::optional<simd::simd_sys_core_c &> simd_core_p;
+      std::size_t                              dom_idx  = 0;  // Planner domain
+      std::size_t                              port_idx = 0;  // Port of the muxes of the domain
    };
 
-   typedef std::list<core_data_t> core_list_t;
+   typedef std::vector<core_data_t> core_list_t;
+
+   // Planner domain: cores with their own planner and muxes
+   class dom_data_t {
+   public:
+      std::string                              name;
+      boost::regex                             core_rgxp;         // Cores of the domain
+      boost::regex                             thrd_rgxp;         // Threads of the domain
+      std::string                              fwd_mask;          // Executors of the other domains whose completions are imported
+      boost::regex                             fwd_rgxp;
+      core_list_t                              core_list;
+      std::unordered_set<std::string>          task_set;          // Tasks run by the threads of the domain
+      boost_pt::ptree                          thrd_pt;
+      boost_pt::ptree                          task_pt;
+      boost_pt::ptree                          exec_pt;
+      schd::schd_planner_c                    *plan_p = nullptr;
+      schd::schd_ptree_xbar_c                 *mux_p  = nullptr;  // Core->planner mux of the only domain
+      schd::cosim_domain_c                    *dom_p  = nullptr;  // Core->planner mux with forwarding between the domains
+   };
+
+   typedef std::vector<dom_data_t> dom_list_t;
+
+   // Group the cores, threads, tasks and executors into the planner domains. Without the domains
+   // preferences all the cores are in one domain
+   void dom_list_init(
+         boost::optional<const boost_pt::ptree&>  cosim_pref_p,
+         core_list_t&                             core_list,
+         dom_list_t&                              dom_list ) {
+      boost::optional<const boost_pt::ptree&> dom_pref_p;
+
+      if( cosim_pref_p.is_initialized()) {
+         dom_pref_p = cosim_pref_p.get().get_child_optional( "domains" );
+      }
+
+      if( !dom_pref_p.is_initialized() ||
+          dom_pref_p.get().size() == 0 ) {
+         dom_list.resize( 1 );
+
+         BOOST_FOREACH( core_list_t::value_type& core_el, core_list ) {
+            core_el.port_idx = core_el.idx;
+         }
+
+         dom_list[0].core_list = core_list;
+
+         return;
+      }
+
+      std::unordered_set<std::string> dom_name_set;
+
+      BOOST_FOREACH( const boost_pt::ptree::value_type& dom_el, dom_pref_p.get()) {
+         if( !dom_el.first.empty()) {
+            SCHD_REPORT_ERROR( "cosim::main" ) << " Incorrect structure of domain preferences";
+         }
+
+         dom_data_t dom_data;
+
+         try {
+            dom_data.name      = dom_el.second.get<std::string>( "name" );
+            dom_data.core_rgxp = boost::regex( dom_el.second.get<std::string>( "cores",   "^$" ));
+            dom_data.thrd_rgxp = boost::regex( dom_el.second.get<std::string>( "threads", "^$" ));
+            dom_data.fwd_mask  = dom_el.second.get<std::string>( "import", "" );
+
+            if( !dom_data.fwd_mask.empty()) {
+               dom_data.fwd_rgxp = boost::regex( dom_data.fwd_mask );
+            }
+         }
+         catch( const boost_pt::ptree_error& err ) {
+            SCHD_REPORT_ERROR( "cosim::main" ) << err.what();
+         }
+         catch( const std::exception& err ) {
+            SCHD_REPORT_ERROR( "cosim::main" ) << " Incorrect domain preferences: " << err.what();
+         }
+         catch( ... ) {
+            SCHD_REPORT_ERROR( "cosim::main" ) << " Unexpected";
+         }
+
+         if( !dom_name_set.insert( dom_data.name ).second ) {
+            SCHD_REPORT_ERROR( "cosim::main" ) << " Duplicate domain: " << dom_data.name;
+         }
+
+         dom_list.push_back( dom_data );
+      } // BOOST_FOREACH( const boost_pt::ptree::value_type& dom_el, dom_pref_p.get())
+
+      // The SCHD core and the cores which don't match any domain are in the first domain
+      std::unordered_map<std::string, std::size_t> core_dom_list;
+
+      BOOST_FOREACH( core_list_t::value_type& core_el, core_list ) {
+         for( std::size_t dom_idx = 0;
+              dom_idx < dom_list.size() && !core_el.schd_core_p.is_initialized();
+              dom_idx ++ ) {
+            if( boost::regex_match( core_el.name, dom_list[dom_idx].core_rgxp )) {
+               core_el.dom_idx = dom_idx;
+               break;
+            }
+         }
+
+         core_el.port_idx = dom_list[core_el.dom_idx].core_list.size();
+         dom_list[core_el.dom_idx].core_list.push_back( core_el );
+
+         core_dom_list[core_el.name] = core_el.dom_idx;
+      }
+
+      // Threads which don't match any domain are in the first domain
+      BOOST_FOREACH( const boost_pt::ptree::value_type& thrd_el, schd::cosim_pref.get_pref( "threads" ).get()) {
+         std::string thrd_name = thrd_el.second.get<std::string>( "name", "" );
+         std::size_t thrd_dom  = 0;
+
+         for( std::size_t dom_idx = 0; dom_idx < dom_list.size(); dom_idx ++ ) {
+            if( boost::regex_match( thrd_name, dom_list[dom_idx].thrd_rgxp )) {
+               thrd_dom = dom_idx;
+               break;
+            }
+         }
+
+         dom_list[thrd_dom].thrd_pt.push_back( thrd_el );
+
+         BOOST_FOREACH( const boost_pt::ptree::value_type& seq_el,
+                        thrd_el.second.get_child( "sequence", boost_pt::ptree())) {
+            boost::optional<std::string> task_p = seq_el.second.get_optional<std::string>( "task.run" );
+
+            if( task_p.is_initialized()) {
+               dom_list[thrd_dom].task_set.insert( task_p.get());
+            }
+         }
+      } // BOOST_FOREACH( const boost_pt::ptree::value_type& thrd_el, ...
+
+      // Each planner gets the tasks of its threads
+      BOOST_FOREACH( const boost_pt::ptree::value_type& task_el, schd::cosim_pref.get_pref( "tasks" ).get()) {
+         std::string task_name = task_el.second.get<std::string>( "name", "" );
+
+         BOOST_FOREACH( dom_list_t::value_type& dom_el, dom_list ) {
+            if( dom_el.task_set.count( task_name ) != 0 ) {
+               dom_el.task_pt.push_back( task_el );
+            }
+         }
+      }
+
+      // Executors of the cores of the domain and the imported executors. The rest are in the first domain
+      BOOST_FOREACH( const boost_pt::ptree::value_type& exec_el, schd::cosim_pref.get_pref( "executors" ).get()) {
+         std::string exec_name = exec_el.second.get<std::string>( "name", "" );
+         std::size_t exec_dom  = 0;
+
+         std::unordered_map<std::string, std::size_t>::const_iterator core_it =
+               core_dom_list.find( exec_name.substr( 0, exec_name.find( '.' )));
+
+         if( core_it != core_dom_list.end()) {
+            exec_dom = core_it->second;
+         }
+
+         for( std::size_t dom_idx = 0; dom_idx < dom_list.size(); dom_idx ++ ) {
+            if( dom_idx == exec_dom ||
+                ( !dom_list[dom_idx].fwd_mask.empty() &&
+                  boost::regex_match( exec_name, dom_list[dom_idx].fwd_rgxp ))) {
+               dom_list[dom_idx].exec_pt.push_back( exec_el );
+            }
+         }
+      } // BOOST_FOREACH( const boost_pt::ptree::value_type& exec_el, ...
+
+      BOOST_FOREACH( const dom_list_t::value_type& dom_el, dom_list ) {
+         SCHD_REPORT_INFO( "cosim::main" ) << " Domain: "     << dom_el.name
+                                           << " Cores: "      << dom_el.core_list.size()
+                                           << " Threads: "    << dom_el.thrd_pt.size()
+                                           << " Executors: "  << dom_el.exec_pt.size();
+      }
+   } // void dom_list_init(
+
+   // Connect the core to the core->planner mux of its domain
+   template<class EXPORT_T>
+   void core_plan_bind(
+         dom_data_t&                              dom_data,
+         std::size_t                              port_idx,
+         EXPORT_T&                                plan_ei ) {
+      if( dom_data.mux_p != nullptr ) {
+         dom_data.mux_p->vi.at( port_idx ).bind( plan_ei );
+      }
+      else {
+         dom_data.dom_p->vi.at( port_idx ).bind( plan_ei );
+      }
+   } // void core_plan_bind(
+
+   // Initialize planner->core mux and connect it to the planner and to the cores
+   template<class MUX_T>
+   void mux_plan_core_init(
+         MUX_T&                                   mux,
+         const boost_pt::ptree&                   mux_pref_pt,
+         sc_core::sc_fifo<schd::schd_sig_ptree_c>& chn_plan_core,
+         const core_list_t&                       core_list ) {
+      mux.init(
+            boost::optional<const boost_pt::ptree&>( mux_pref_pt ));
+
+      mux.vi.at( 0 ).bind( chn_plan_core );
+
+      BOOST_FOREACH( const schd::core_list_t::value_type& core_el, core_list ) {
+         if( core_el.schd_core_p.is_initialized()) { // SCHD core
+            mux.vo.at( core_el.port_idx ).bind(
+                  core_el.schd_core_p.get().plan_eo );
+         }
+         else { // SIMD cores
+            mux.vo.at( core_el.port_idx ).bind(
+                  core_el.adapter_p.get().plan_eo );
+         }
+      }
+   } // void mux_plan_core_init(
 } // namespace schd
 
 int sc_main(
    int argc,
    char *argv[] ) {
 
+   std::string play_file; // Stream to be converted into .mat
+
    // Check command line arguments
    if( argc == 2 ) {
       std::string argv1 = argv[1];
 
       SCHD_REPORT_INFO( "cosim::cmdline" ) << "Preferences file: " << argv1;
 
-      schd::schd_pref.load( argv1 );
+      schd::cosim_pref.load( argv1 );
+   }
+   else if( argc == 4 && std::string( argv[1] ) == "--sweep" ) {
+      std::string pref_file;
+
+      SCHD_REPORT_INFO( "cosim::cmdline" ) << "Preferences file: " << argv[2] << " Sweep: " << argv[3];
+
+      // Only the workers continue to the simulation
+      if( !schd::cosim_sweep.run( argv[2], argv[3], pref_file )) {
+         return 0;
+      }
+
+      SCHD_REPORT_INFO( "cosim::cmdline" ) << "Scenario preferences: " << pref_file;
+   }
+   else if( argc == 3 && std::string( argv[1] ) == "--bench" ) {
+      std::string pref_file;
+
+      SCHD_REPORT_INFO( "cosim::cmdline" ) << "Benchmark: " << argv[2];
+
+      // Only the workers continue to the simulation
+      if( !schd::cosim_bench.run( argv[2], pref_file )) {
+         return schd::cosim_bench.status();
+      }
+
+      SCHD_REPORT_INFO( "cosim::cmdline" ) << "Point preferences: " << pref_file;
+   }
+   else if( argc == 3 && std::string( argv[1] ) == "--restore" ) {
+      SCHD_REPORT_INFO( "cosim::cmdline" ) << "Restore from: " << argv[2];
+
+      return schd::cosim_ckpt_c::restore( argv[2] );
+   }
+   else if( argc == 3 && std::string( argv[1] ) == "--restore-stop" ) {
+      return schd::cosim_ckpt_c::stop( argv[2] );
+   }
+   else if( argc == 4 && std::string( argv[1] ) == "--stream2mat" ) {
+      play_file = argv[2];
+
+      SCHD_REPORT_INFO( "cosim::cmdline" ) << "Stream: " << argv[2] << " Preferences file: " << argv[3];
+
+      schd::cosim_pref.load( argv[3] );
    }
    else {
       SCHD_REPORT_ERROR( "cosim::cmdline" ) << "Incorrect command line arguments";
    }
 
+   // Co-simulation preferences
+   boost::optional<const boost_pt::ptree&> cosim_pref_p =
+         schd::cosim_pref.get_pref( "cosim" );
+
+   // Create processes for the SIMD cores in parallel mode before any output file is opened.
+   // part_idx is 0 in the planner process and index of the SIMD core in the core process
+   if( play_file.empty()) {
+      schd::cosim_part.init(
+            cosim_pref_p,
+            schd::cosim_pref.get_pref( "simd" ));
+   }
+
+   std::size_t part_idx  = schd::cosim_part.fork_cores();
+   bool        plan_side = ( part_idx == 0 );
+   bool        simd_side = ( part_idx != 0 || !schd::cosim_part.enabled());
+
    schd::schd_report.init(
-         schd::schd_pref.get_pref( "report" ));
+         schd::cosim_pref.get_pref( "report" ));
 
    schd::schd_time.init(
-         schd::schd_pref.get_pref( "time" ));
+         schd::cosim_pref.get_pref( "time" ));
    simd::simd_time.init(
-         schd::schd_pref.get_pref( "time" ));
+         schd::cosim_pref.get_pref( "time" ));
 
    sc_core::sc_set_time_resolution(
          schd::schd_time.res_sec,
          sc_core::SC_SEC );
 
+   // Checkpoint time is converted with the time resolution
+   schd::cosim_ckpt.init(
+         cosim_pref_p );
+
+   if( schd::cosim_ckpt.enabled() && schd::cosim_part.enabled()) {
+      SCHD_REPORT_ERROR( "cosim::main" ) << " Checkpoint is not supported in parallel mode";
+   }
+
+   if( schd::cosim_ckpt.enabled() &&
+       schd::schd_time.end_sec != 0.0 &&
+       schd::cosim_ckpt.time_get().to_seconds() >= schd::schd_time.end_sec ) {
+      SCHD_REPORT_ERROR( "cosim::main" ) << " Checkpoint time is not before the end of the simulation";
+   }
+
+   // Convert the stream into .mat files with the dump preferences
+   if( !play_file.empty()) {
+      schd::schd_dump.init(
+            schd::cosim_pref.get_pref( "dump" ));
+
+      schd::cosim_stream_play_c *play_raw_ptr = new schd::cosim_stream_play_c( "stream2mat" );
+      play_raw_ptr->init( play_file );
+
+      sc_core::sc_start();
+
+      schd::schd_dump.close_all();
+
+      return 0;
+   }
+
    // Set trace for schd
    schd::schd_trace.init(
-         schd::schd_pref.get_pref( "trace" ));
+         schd::cosim_pref.get_pref( "trace" ));
 
    schd::schd_trace.save_map(
-         schd::schd_pref.get_pref( "threads" ));
+         schd::cosim_pref.get_pref( "threads" ));
 
    // Set trace for simd by reference
    simd::simd_trace.init(
-         schd::schd_pref.get_pref( "trace" ),
+         schd::cosim_pref.get_pref( "trace" ),
          schd::schd_trace.tf );
 
-   // Create SCHD PLANNER
-   schd::schd_planner_c plan_i0(
-         "planner" );
-   plan_i0.init(
-         schd::schd_pref.get_pref( "threads"   ),
-         schd::schd_pref.get_pref( "tasks"     ),
-         schd::schd_pref.get_pref( "executors" ));
+   // Binary trace of the adapters
+   schd::cosim_trace.init(
+         schd::cosim_pref.get_pref( "trace" ));
+
+   if( schd::cosim_trace.enabled() && schd::cosim_ckpt.enabled()) {
+      SCHD_REPORT_ERROR( "cosim::main" ) << " Checkpoint is not supported with the binary trace";
+   }
+
+   // Record or replay of the adapter boundary
+   schd::cosim_rec.init(
+         cosim_pref_p );
+
+   if(( schd::cosim_rec.enabled() || schd::cosim_rec.rply_get() != schd::cosim_rec_c::RPLY_NONE ) &&
+      ( schd::cosim_ckpt.enabled() || schd::cosim_part.enabled())) {
+      SCHD_REPORT_ERROR( "cosim::main" ) << " Record and replay are not supported with checkpoint or in parallel mode";
+   }
+
+   // Replay of the SIMD side runs without the planner and the adapters. Replay of the planner side runs without the SIMD cores
+   bool adpt_side = ( schd::cosim_rec.rply_get() != schd::cosim_rec_c::RPLY_SIMD );
+
+   plan_side = plan_side && adpt_side;
+   simd_side = simd_side && ( schd::cosim_rec.rply_get() != schd::cosim_rec_c::RPLY_PLAN );
 
    // Process core preferences
    schd::core_list_t core_list;
@@ -73,13 +394,20 @@ int sc_main(
    // schd core
    core_data.idx  = 0;
    core_data.name = "schd";
-   schd::schd_core_c *schd_core_raw_ptr = new schd::schd_core_c( core_data.name.c_str() );
-   core_data.schd_core_p = boost::optional<schd::schd_core_c &>( *schd_core_raw_ptr );
-   core_list.push_back( core_data );
+
+   if( plan_side ) {
+      schd::schd_core_c *schd_core_raw_ptr = new schd::schd_core_c( core_data.name.c_str() );
+      core_data.schd_core_p = boost::optional<schd::schd_core_c &>( *schd_core_raw_ptr );
+      core_list.push_back( core_data );
+   }
 
    // simd cores
    boost::optional<const boost_pt::ptree&> simd_core_pref_p =
-         schd::schd_pref.get_pref( "simd" );
+         schd::cosim_pref.get_pref( "simd" );
+
+   std::unordered_set<std::string> core_name_set;
+
+   core_name_set.insert( core_data.name );
 
    BOOST_FOREACH( const boost_pt::ptree::value_type& simd_core_pref_el, simd_core_pref_p.get()) {
       if( !simd_core_pref_el.first.empty()) {
@@ -88,84 +416,209 @@ int sc_main(
 
       boost::optional<std::string>            name_p = simd_core_pref_el.second.get_optional<std::string>("name");
       boost::optional<const boost_pt::ptree&> pref_p = simd_core_pref_el.second.get_child_optional("pref");
+      boost::optional<const boost_pt::ptree&> adpt_p = simd_core_pref_el.second.get_child_optional("adapter");
+      boost::optional<std::size_t>            rep_p  = simd_core_pref_el.second.get_optional<std::size_t>("replicate");
 
       if( !name_p.is_initialized() ||
           !pref_p.is_initialized()) {
          SCHD_REPORT_ERROR( "cosim::main" ) << " Incorrect structure of simd core preferences";
       }
 
-      if( core_list.end() != std::find_if(
-            core_list.begin(),
-            core_list.end(),
-            [name_p]( schd::core_list_t::value_type& el )->bool{
-               return name_p.get() == el.name; })) {
-         SCHD_REPORT_ERROR( "cosim::main" ) << " Duplicate name: " << name_p.get();
+      // Core template: the replicas share the preferences. %1% in the name is replaced by the index of the replica
+      std::size_t rep_num = rep_p.is_initialized() ? rep_p.get() : 1;
+
+      if( rep_p.is_initialized() &&
+          name_p.get().find( "%1%" ) == std::string::npos ) {
+         SCHD_REPORT_ERROR( "cosim::main" ) << " Name of the core template must contain %1%: " << name_p.get();
       }
 
-      core_data.idx ++;
-      core_data.name        = name_p.get();
-      core_data.core_pref_p = pref_p;
+      core_list.reserve( core_list.size() + rep_num );
 
-      std::string adpt_name = core_data.name + "_adpt";
-      schd::cosim_adapter_c *adapter_raw_ptr = new schd::cosim_adapter_c( adpt_name.c_str() );
-      core_data.adapter_p = boost::optional<schd::cosim_adapter_c &>( *adapter_raw_ptr );
+      for( std::size_t rep_idx = 0; rep_idx < rep_num; rep_idx ++ ) {
+         core_data.idx ++;
+         core_data.name        = rep_p.is_initialized() ?
+               boost::algorithm::replace_all_copy( name_p.get(), "%1%", std::to_string( rep_idx )) : name_p.get();
+         core_data.core_pref_p = pref_p;
+         core_data.adpt_pref_p = adpt_p;
 
-      simd::simd_sys_core_c *simd_core_raw_ptr = new simd::simd_sys_core_c( core_data.name.c_str() );
-      core_data.simd_core_p = boost::optional<simd::simd_sys_core_c &>( *simd_core_raw_ptr );
+         if( !core_name_set.insert( core_data.name ).second ) {
+            SCHD_REPORT_ERROR( "cosim::main" ) << " Duplicate name: " << core_data.name;
+         }
 
-      core_list.push_back( core_data );
+         if( part_idx != 0 && core_data.idx != part_idx ) { // The core is simulated by another process
+            continue;
+         }
+
+         if( adpt_side ) {
+            std::string adpt_name = core_data.name + "_adpt";
+            schd::cosim_adapter_c *adapter_raw_ptr = new schd::cosim_adapter_c( adpt_name.c_str() );
+            core_data.adapter_p = boost::optional<schd::cosim_adapter_c &>( *adapter_raw_ptr );
+         }
+
+         if( simd_side ) {
+            simd::simd_sys_core_c *simd_core_raw_ptr = new simd::simd_sys_core_c( core_data.name.c_str() );
+            core_data.simd_core_p = boost::optional<simd::simd_sys_core_c &>( *simd_core_raw_ptr );
+         }
+
+         core_list.push_back( core_data );
+      } // for( std::size_t rep_idx = 0; rep_idx < rep_num; rep_idx ++ )
    } // BOOST_FOREACH( const boost_pt::ptree::value_type& simd_core_pref_el, simd_core_pref_p.get())
 
-   // Create and initialize co-simulation mux
-   schd::schd_ptree_xbar_c mux_plan_core( "mux_plan_core" );
-   schd::schd_ptree_xbar_c mux_core_plan( "mux_core_plan" );
+   // Executors of each SIMD core. An adapter only looks through the executors of its core
+   typedef std::unordered_map<std::string, boost_pt::ptree> core_exec_list_t;
 
-   boost_pt::ptree mux_plan_core_pref_pt;
-   boost_pt::ptree mux_core_plan_pref_pt;
-   boost_pt::ptree core_list_pt;
-   boost_pt::ptree plan_list_pt;
-   boost_pt::ptree endpoint_pt;
+   core_exec_list_t core_exec_list;
 
-   endpoint_pt.clear();
-   endpoint_pt.put( "name", "planner" );
-   endpoint_pt.put( "dump", "" ); // don't dump inside xbars
-   plan_list_pt.push_back( std::make_pair( "", endpoint_pt ));
+   BOOST_FOREACH( const boost_pt::ptree::value_type& exec_el, schd::cosim_pref.get_pref( "executors" ).get()) {
+      std::string exec_name = exec_el.second.get<std::string>( "name", "" );
 
+      core_exec_list[exec_name.substr( 0, exec_name.find( '.' ))].push_back( exec_el );
+   }
+
+   // Planner domains
+   schd::dom_list_t dom_list;
+
+   schd::dom_list_init(
+         cosim_pref_p,
+         core_list,
+         dom_list );
+
+   // Create and initialize co-simulation muxes and the planner of each domain
+   std::string mux_mode = cosim_pref_p.is_initialized() ?
+         cosim_pref_p.get().get<std::string>( "router", "xbar" ) : "xbar";
+
+   for( std::size_t dom_idx = 0; dom_idx < dom_list.size() && plan_side; dom_idx ++ ) { // No planner and muxes in the core process
+      schd::dom_data_t& dom_data = dom_list[dom_idx];
+
+      // Names of the only domain are the same as without the domains
+      std::string dom_sfx = ( dom_list.size() == 1 ) ? "" : "_" + dom_data.name;
+
+      boost_pt::ptree mux_plan_core_pref_pt;
+      boost_pt::ptree mux_core_plan_pref_pt;
+      boost_pt::ptree core_list_pt;
+      boost_pt::ptree plan_list_pt;
+      boost_pt::ptree endpoint_pt;
 
-   BOOST_FOREACH( const schd::core_list_t::value_type& core_el, core_list ) {
       endpoint_pt.clear();
-      endpoint_pt.put( "mask", "^" + core_el.name + ".*$" );    // regex
+      endpoint_pt.put( "name", "planner" );
       endpoint_pt.put( "dump", "" ); // don't dump inside xbars
-      core_list_pt.push_back( std::make_pair( "", endpoint_pt ));
-   }
+      plan_list_pt.push_back( std::make_pair( "", endpoint_pt ));
+
+      BOOST_FOREACH( const schd::core_list_t::value_type& core_el, dom_data.core_list ) {
+         endpoint_pt.clear();
+         endpoint_pt.put( "mask", "^" + core_el.name + "\\..*$" ); // regex. The dot keeps simd_1 from matching simd_10
+         endpoint_pt.put( "dump", "" ); // don't dump inside xbars
+         core_list_pt.push_back( std::make_pair( "", endpoint_pt ));
+      }
+
+      mux_plan_core_pref_pt.add_child( "src_list", plan_list_pt );
+      mux_plan_core_pref_pt.add_child( "dst_list", core_list_pt );
 
-   mux_plan_core_pref_pt.add_child( "src_list", plan_list_pt );
-   mux_plan_core_pref_pt.add_child( "dst_list", core_list_pt );
+      mux_core_plan_pref_pt.add_child( "src_list", core_list_pt );
+      mux_core_plan_pref_pt.add_child( "dst_list", plan_list_pt );
 
-   mux_core_plan_pref_pt.add_child( "src_list", core_list_pt );
-   mux_core_plan_pref_pt.add_child( "dst_list", plan_list_pt );
+      // Create SCHD PLANNER
+      dom_data.plan_p = new schd::schd_planner_c(( "planner" + dom_sfx ).c_str());
 
-   mux_plan_core.init(
-         boost::optional<const boost_pt::ptree&>( mux_plan_core_pref_pt ));
+      if( dom_list.size() == 1 ) {
+         dom_data.plan_p->init(
+               schd::cosim_pref.get_pref( "threads"   ),
+               schd::cosim_pref.get_pref( "tasks"     ),
+               schd::cosim_pref.get_pref( "executors" ));
+      }
+      else {
+         dom_data.plan_p->init(
+               boost::optional<const boost_pt::ptree&>( dom_data.thrd_pt ),
+               boost::optional<const boost_pt::ptree&>( dom_data.task_pt ),
+               boost::optional<const boost_pt::ptree&>( dom_data.exec_pt ));
+      }
+
+      // Create channels and connect co-sim muxes and planner
+      sc_core::sc_fifo<schd::schd_sig_ptree_c> *chn_core_plan_ptr =
+            new sc_core::sc_fifo<schd::schd_sig_ptree_c>(( "chn_core_plan" + dom_sfx ).c_str(), 64 );
+      sc_core::sc_fifo<schd::schd_sig_ptree_c> *chn_plan_core_ptr =
+            new sc_core::sc_fifo<schd::schd_sig_ptree_c>(( "chn_plan_core" + dom_sfx ).c_str(), 64 );
 
-   mux_core_plan.init(
-         boost::optional<const boost_pt::ptree&>( mux_core_plan_pref_pt ));
+      dom_data.plan_p->core_o.bind( *chn_plan_core_ptr );
 
-   // Create channels and connect co-sim mux and planner
-   sc_core::sc_fifo<schd::schd_sig_ptree_c> chn_core_plan( "chn_core_plan", 64 );
-   sc_core::sc_fifo<schd::schd_sig_ptree_c> chn_plan_core( "chn_plan_core", 64 );
+      if( mux_mode == "prefix" ) { // Prefix masks are resolved with a trie
+         schd::cosim_router_c *mux_plan_core_raw_ptr = new schd::cosim_router_c(( "mux_plan_core" + dom_sfx ).c_str());
 
-   plan_i0.core_o.bind( chn_plan_core );
-   mux_plan_core.vi.at( 0 ).bind( chn_plan_core );
+         schd::mux_plan_core_init(
+               *mux_plan_core_raw_ptr,
+               mux_plan_core_pref_pt,
+               *chn_plan_core_ptr,
+               dom_data.core_list );
+      }
+      else if( mux_mode == "xbar" ) {
+         schd::schd_ptree_xbar_c *mux_plan_core_raw_ptr = new schd::schd_ptree_xbar_c(( "mux_plan_core" + dom_sfx ).c_str());
+
+         schd::mux_plan_core_init(
+               *mux_plan_core_raw_ptr,
+               mux_plan_core_pref_pt,
+               *chn_plan_core_ptr,
+               dom_data.core_list );
+      }
+      else {
+         SCHD_REPORT_ERROR( "cosim::main" ) << " Incorrect router: " << mux_mode;
+      }
+
+      if( dom_list.size() == 1 ) {
+         dom_data.mux_p = new schd::schd_ptree_xbar_c( "mux_core_plan" );
+         dom_data.mux_p->init(
+               boost::optional<const boost_pt::ptree&>( mux_core_plan_pref_pt ));
+
+         dom_data.mux_p->vo.at( 0 ).bind( *chn_core_plan_ptr );
+      }
+      else { // Completions imported by the other domains are forwarded to their muxes
+         std::vector<std::string> fwd_mask_list;
 
-   mux_core_plan.vo.at( 0 ).bind( chn_core_plan );
-   plan_i0.core_i.bind( chn_core_plan );
+         for( std::size_t fwd_idx = 0; fwd_idx < dom_list.size(); fwd_idx ++ ) {
+            if( fwd_idx != dom_idx ) {
+               fwd_mask_list.push_back( dom_list[fwd_idx].fwd_mask );
+            }
+         }
+
+         dom_data.dom_p = new schd::cosim_domain_c(( "mux_core_plan" + dom_sfx ).c_str());
+         dom_data.dom_p->init(
+               dom_data.core_list.size(),
+               fwd_mask_list );
+
+         dom_data.dom_p->plan_o.bind( *chn_core_plan_ptr );
+      }
+
+      dom_data.plan_p->core_i.bind( *chn_core_plan_ptr );
+   } // for( std::size_t dom_idx = 0; dom_idx < dom_list.size() && plan_side; dom_idx ++ )
+
+   // Connect the muxes of the domains to each other in the order of fwd_mask_list
+   for( std::size_t dom_idx = 0; dom_idx < dom_list.size() && dom_list.size() > 1 && plan_side; dom_idx ++ ) {
+      std::size_t port_idx = 0;
+
+      for( std::size_t fwd_idx = 0; fwd_idx < dom_list.size(); fwd_idx ++ ) {
+         if( fwd_idx != dom_idx ) {
+            dom_list[dom_idx].dom_p->fwd_o.at( port_idx ++ ).bind(
+                  dom_list[fwd_idx].dom_p->fwd_eo );
+         }
+      }
+   }
+
+   // Create and initialise statistics of the adapters
+   schd::cosim_stat_c stat_i0(
+         "stats" );
+   stat_i0.init(
+         cosim_pref_p );
+
+   // Create and initialise progress heartbeat
+   schd::cosim_beat_c beat_i0(
+         "heartbeat" );
+   beat_i0.init(
+         cosim_pref_p );
 
    // Create and initialise SIMD CRM instance
    simd::simd_sys_crm_c crm_i0(
          "crm");
    crm_i0.init(
-         schd::schd_pref.get_pref( "clock" ));
+         schd::cosim_pref.get_pref( "clock" ));
 
    // Create and connect clock and reset channels
    sc_core::sc_signal<bool> reset;
@@ -179,81 +632,165 @@ int sc_main(
    BOOST_FOREACH( const schd::core_list_t::value_type& core_el, core_list ) {
       if( core_el.idx == 0 ) { // SCHD core
          core_el.schd_core_p.get().init(
-               schd::schd_pref.get_pref( "executors" ),
-               schd::schd_pref.get_pref( "common"    ));
+               schd::cosim_pref.get_pref( "executors" ),
+               schd::cosim_pref.get_pref( "common"    ));
 
          // Connect co-sim mux and schd core
-         mux_plan_core.vo.at( core_el.idx ).bind(
-               core_el.schd_core_p.get().plan_eo );
-
-         mux_core_plan.vi.at( core_el.idx ).bind(
+         schd::core_plan_bind(
+               dom_list[core_el.dom_idx],
+               core_el.port_idx,
                core_el.schd_core_p.get().plan_ei );
 
       } // if( core_el.schd )
-      else { // a bunch of SIMD cores
+      else if( !adpt_side ) { // SIMD cores are driven from the recording by their scalar processors
          core_el.simd_core_p.get().init(
                core_el.core_pref_p );
 
-         core_el.adapter_p.get().init(
-               schd::schd_pref.get_pref( "executors" ),     // SCHD exec preferences
-               core_el.core_pref_p );                       // SIMD core preferences
-
-         core_el.adapter_p.get().add_trace(
-               schd::schd_trace.tf,
-               "" );
-
          // connect clock and reset channels
          core_el.simd_core_p.get().clock_i.bind(
                clock );
          core_el.simd_core_p.get().reset_i.bind(
                reset );
+      }
+      else { // a bunch of SIMD cores
+         core_el.adapter_p.get().init(
+               boost::optional<const boost_pt::ptree&>(
+                     core_exec_list[core_el.name] ),        // SCHD exec preferences of the core
+               core_el.core_pref_p,                         // SIMD core preferences
+               core_el.adpt_pref_p );                       // Adapter preferences
+
+         core_el.adapter_p.get().add_trace(
+               schd::schd_trace.tf,
+               "" );
 
          core_el.adapter_p.get().clock_i.bind(
                clock );
          core_el.adapter_p.get().reset_i.bind(
                reset );
 
-         // Connect ADAPTER to SIMD CORE
-         core_el.adapter_p.get().event_i.bind(
-               core_el.simd_core_p.get().event_ei );
-         core_el.adapter_p.get().busr_i.bind(
-               core_el.simd_core_p.get().busr_ei );
-         core_el.adapter_p.get().busw_o.bind(
-               core_el.simd_core_p.get().busw_eo );
-
-         // Connect co-sim mux and ADAPTER
-         mux_plan_core.vo.at( core_el.idx ).bind(
-               core_el.adapter_p.get().plan_eo );
-
-         mux_core_plan.vi.at( core_el.idx ).bind(
-               core_el.adapter_p.get().plan_ei );
+         if( simd_side ) {
+            core_el.simd_core_p.get().init(
+                  core_el.core_pref_p );
+
+            // connect clock and reset channels. With the clock gating the core is clocked by the adapter
+            if( core_el.adapter_p.get().gate_enabled()) {
+               sc_core::sc_signal<bool>* clock_gate_p =
+                     new sc_core::sc_signal<bool>(( core_el.name + "_clock" ).c_str());
+
+               core_el.adapter_p.get().clock_o.bind(
+                     *clock_gate_p );
+               core_el.simd_core_p.get().clock_i.bind(
+                     *clock_gate_p );
+            }
+            else {
+               core_el.simd_core_p.get().clock_i.bind(
+                     clock );
+            }
+
+            core_el.simd_core_p.get().reset_i.bind(
+                  reset );
+
+            // Connect ADAPTER to SIMD CORE
+            core_el.adapter_p.get().event_i.bind(
+                  core_el.simd_core_p.get().event_ei );
+            core_el.adapter_p.get().busr_i.bind(
+                  core_el.simd_core_p.get().busr_ei );
+            core_el.adapter_p.get().busw_o.bind(
+                  core_el.simd_core_p.get().busw_eo );
+         }
+         else { // SIMD core is in another process. The adapter front-end doesn't use these ports
+            std::string chn_name = core_el.name + "_chn_";
+
+            core_el.adapter_p.get().event_i.bind(
+                  *new sc_core::sc_fifo<simd::simd_sig_ptree_c>(( chn_name + "evnt" ).c_str(), 1 ));
+            core_el.adapter_p.get().busr_i.bind(
+                  *new sc_core::sc_fifo<simd::simd_sig_ptree_c>(( chn_name + "busr" ).c_str(), 1 ));
+            core_el.adapter_p.get().busw_o.bind(
+                  *new sc_core::sc_fifo<simd::simd_sig_ptree_c>(( chn_name + "busw" ).c_str(), 1 ));
+         }
+
+         if( plan_side ) {
+            // Connect co-sim mux and ADAPTER
+            schd::core_plan_bind(
+                  dom_list[core_el.dom_idx],
+                  core_el.port_idx,
+                  core_el.adapter_p.get().plan_ei );
+         }
+
+         if( schd::cosim_part.enabled()) {
+            schd::cosim_part.add_adapter(
+                  core_el.adapter_p.get());
+         }
+
+         stat_i0.add_adapter(
+               core_el.adapter_p.get());
+         beat_i0.add_adapter(
+               core_el.adapter_p.get());
       } // if( core_el.schd ) ... else ...
    } // BOOST_FOREACH( const schd::core_list_t::value_type& core_el, core_list )
 
    // Init memory pool (virtual component) for all SIMD cores
    simd::simd_sys_pool.init(
-         schd::schd_pref.get_pref( "pool" ));
+         schd::cosim_pref.get_pref( "pool" ));
 
    // Init data dump class for schd and for simd
    schd::schd_dump.init(
-         schd::schd_pref.get_pref( "dump" ));
+         schd::cosim_pref.get_pref( "dump" ));
 
    simd::simd_dump.init(
-         schd::schd_pref.get_pref( "dump" ));
+         schd::cosim_pref.get_pref( "dump" ));
+
+   // Streaming dump of the adapters
+   schd::cosim_stream.init(
+         cosim_pref_p );
+
+   if( schd::cosim_stream.enabled() && schd::cosim_ckpt.enabled()) {
+      SCHD_REPORT_ERROR( "cosim::main" ) << " Checkpoint is not supported with the streaming dump";
+   }
 
    // Invoke the simulation
-   if( schd::schd_time.end_sec != 0.0 ) {
+   if( schd::cosim_ckpt.enabled()) {
       sc_core::sc_start(
-            schd::schd_time.end_sec,
-            sc_core::SC_SEC );
+            schd::cosim_ckpt.time_get());
+
+      // No snapshot after the early stop of the heartbeat
+      if( !beat_i0.stop_get()) {
+         // Buffered output is written before the fork, so that it is not duplicated in the snapshot
+         stat_i0.flush();
+
+         // Both the running process and the restored copies continue from here
+         schd::cosim_ckpt.save();
+      }
    }
-   else {
-      sc_core::sc_start();
+
+   if( schd::cosim_part.enabled()) {
+      schd::cosim_part.run(
+            sc_core::sc_time( schd::schd_time.end_sec, sc_core::SC_SEC ),
+            beat_i0 );
+   }
+   else if( !beat_i0.stop_get()) { // Not stopped by the heartbeat before the checkpoint
+      if( schd::schd_time.end_sec != 0.0 ) {
+         sc_core::sc_start(
+               sc_core::sc_time( schd::schd_time.end_sec, sc_core::SC_SEC ) -
+               sc_core::sc_time_stamp());
+      }
+      else {
+         sc_core::sc_start();
+      }
    }
 
    SCHD_REPORT_INFO( "cosim::main" ) << "Done.";
 
+   schd::cosim_sweep.summary();
+   schd::cosim_bench.summary();
+
+   stat_i0.dump();
+   beat_i0.close();
+
    // Ensure that all the dump files are closed before exiting
+   schd::cosim_stream.close();
+   schd::cosim_trace.close();
+   schd::cosim_rec.close();
    schd::schd_dump.close_all();
    simd::simd_dump.close_all();
 
@@ -0,0 +1,130 @@
+/*
+ * cosim_msg.cpp
+ *
+ *  Description: Reference-counted messages and the packet pool
+ */
+
+#include <utility>
+#include "cosim_msg.h"
+
+namespace schd {
+
+// Global instance
+cosim_msg_pool_c cosim_msg_pool;
+
+cosim_msg_c::cosim_msg_c(
+      const cosim_msg_c&                   msg )
+   : slot_idx( msg.slot_idx ) {
+   if( slot_idx != slot_none ) {
+      cosim_msg_pool.retain( slot_idx );
+   }
+} // cosim_msg_c::cosim_msg_c(
+
+cosim_msg_c::cosim_msg_c(
+      cosim_msg_c&&                        msg )
+   : slot_idx( msg.slot_idx ) {
+   msg.slot_idx = slot_none;
+} // cosim_msg_c::cosim_msg_c(
+
+cosim_msg_c::~cosim_msg_c(
+      void ) {
+   reset();
+} // cosim_msg_c::~cosim_msg_c(
+
+cosim_msg_c& cosim_msg_c::operator=(
+      cosim_msg_c                          msg ) {
+   std::swap( slot_idx, msg.slot_idx );
+
+   return *this;
+} // cosim_msg_c& cosim_msg_c::operator=(
+
+const schd_sig_ptree_c& cosim_msg_c::sig(
+      void ) const {
+   return cosim_msg_pool.slot_list[slot_idx].sig;
+} // const schd_sig_ptree_c& cosim_msg_c::sig(
+
+const boost_pt::ptree& cosim_msg_c::get(
+      void ) const {
+   return cosim_msg_pool.slot_list[slot_idx].sig.get();
+} // const boost_pt::ptree& cosim_msg_c::get(
+
+bool cosim_msg_c::empty(
+      void ) const {
+   return slot_idx == slot_none;
+} // bool cosim_msg_c::empty(
+
+void cosim_msg_c::reset(
+      void ) {
+   if( slot_idx != slot_none ) {
+      cosim_msg_pool.release( slot_idx );
+      slot_idx = slot_none;
+   }
+} // void cosim_msg_c::reset(
+
+cosim_msg_c cosim_msg_pool_c::read(
+      sc_core::sc_fifo_in_if<schd_sig_ptree_c>& fifo ) {
+   cosim_msg_c msg;
+
+   msg.slot_idx = alloc();
+   fifo.read( slot_list[msg.slot_idx].sig );
+
+   return msg;
+} // cosim_msg_c cosim_msg_pool_c::read(
+
+cosim_msg_c cosim_msg_pool_c::make(
+      const boost_pt::ptree&               pt ) {
+   cosim_msg_c msg;
+
+   msg.slot_idx = alloc();
+   slot_list[msg.slot_idx].sig.set( pt );
+
+   return msg;
+} // cosim_msg_c cosim_msg_pool_c::make(
+
+boost_pt::ptree& cosim_msg_pool_c::stat_get(
+      boost_pt::ptree&                     stat_pt ) const {
+   stat_pt.clear();
+   stat_pt.put( "messages", msg_count );
+   stat_pt.put( "slots",    slot_list.size());
+   stat_pt.put( "peak",     slot_peak );
+
+   return stat_pt;
+} // boost_pt::ptree& cosim_msg_pool_c::stat_get(
+
+std::size_t cosim_msg_pool_c::alloc(
+      void ) {
+   std::size_t slot_idx;
+
+   if( slot_free.empty()) {
+      slot_idx = slot_list.size();
+      slot_list.push_back( slot_data_t());
+   }
+   else {
+      slot_idx = slot_free.back();
+      slot_free.pop_back();
+   }
+
+   slot_list[slot_idx].ref_count = 1;
+   msg_count ++;
+
+   if( slot_list.size() - slot_free.size() > slot_peak ) {
+      slot_peak = slot_list.size() - slot_free.size();
+   }
+
+   return slot_idx;
+} // std::size_t cosim_msg_pool_c::alloc(
+
+void cosim_msg_pool_c::retain(
+      std::size_t                          slot_idx ) {
+   slot_list[slot_idx].ref_count ++;
+} // void cosim_msg_pool_c::retain(
+
+void cosim_msg_pool_c::release(
+      std::size_t                          slot_idx ) {
+   // The packet stays in the slot until it is overwritten by the next message
+   if( -- slot_list[slot_idx].ref_count == 0 ) {
+      slot_free.push_back( slot_idx );
+   }
+} // void cosim_msg_pool_c::release(
+
+} // namespace schd
@@ -0,0 +1,320 @@
+/*
+ * cosim_part.cpp
+ *
+ *  Description: Partitioned simulation of the SIMD cores
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <boost/foreach.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include "cosim_part.h"
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+// Global instance
+cosim_part_c cosim_part;
+
+void cosim_part_c::init(
+      boost::optional<const boost_pt::ptree&> cosim_pref_p,
+      boost::optional<const boost_pt::ptree&> simd_pref_p ) {
+
+   std::string part_mode = "none";
+
+   if( cosim_pref_p.is_initialized()) {
+      part_mode = cosim_pref_p.get().get<std::string>( "parallel", "none" );
+   }
+
+   if( part_mode == "none" ) {
+      part_en = false;
+      return;
+   }
+   else if( part_mode != "core" ) {
+      SCHD_REPORT_ERROR( "cosim::part" ) << "Incorrect parallel mode: " << part_mode;
+   }
+
+   part_en = true;
+
+   BOOST_FOREACH( const boost_pt::ptree::value_type& simd_core_pref_el, simd_pref_p.get()) {
+      boost::optional<std::string> name_p = simd_core_pref_el.second.get_optional<std::string>("name");
+      boost::optional<std::size_t> rep_p  = simd_core_pref_el.second.get_optional<std::size_t>("replicate");
+
+      if( !name_p.is_initialized()) {
+         SCHD_REPORT_ERROR( "cosim::part" ) << "Incorrect structure of simd core preferences";
+      }
+
+      // One process per replica of the core template
+      for( std::size_t rep_idx = 0; rep_idx < ( rep_p.is_initialized() ? rep_p.get() : 1 ); rep_idx ++ ) {
+         peer_list.push_back( peer_data_t());
+         peer_list.back().name = rep_p.is_initialized() ?
+               boost::algorithm::replace_all_copy( name_p.get(), "%1%", std::to_string( rep_idx )) : name_p.get();
+      }
+   }
+} // void cosim_part_c::init(
+
+bool cosim_part_c::enabled(
+      void ) const {
+   return part_en;
+} // bool cosim_part_c::enabled(
+
+std::size_t cosim_part_c::fork_cores(
+      void ) {
+   if( !part_en ) {
+      return 0;
+   }
+
+   for( std::size_t peer_idx = 0; peer_idx < peer_list.size(); peer_idx ++ ) {
+      int plan_fd[2]; // parent->child
+      int done_fd[2]; // child->parent
+
+      if( pipe( plan_fd ) != 0 ||
+          pipe( done_fd ) != 0 ) {
+         SCHD_REPORT_ERROR( "cosim::part" ) << "Pipe error: " << std::strerror( errno );
+      }
+
+      int pid = fork();
+
+      if( pid < 0 ) {
+         SCHD_REPORT_ERROR( "cosim::part" ) << "Fork error: " << std::strerror( errno );
+      }
+      else if( pid == 0 ) { // Child
+         peer_data_t parent;
+
+         // Descriptors of the cores created before belong to the parent
+         for( std::size_t prev_idx = 0; prev_idx < peer_idx; prev_idx ++ ) {
+            close( peer_list[prev_idx].fd_rd );
+            close( peer_list[prev_idx].fd_wr );
+         }
+
+         close( plan_fd[1] );
+         close( done_fd[0] );
+
+         parent.name  = "parent";
+         parent.pid   = getppid();
+         parent.fd_rd = plan_fd[0];
+         parent.fd_wr = done_fd[1];
+
+         // Output files of the core go to its own directory
+         if(( mkdir( peer_list[peer_idx].name.c_str(), 0755 ) != 0 && errno != EEXIST ) ||
+            chdir( peer_list[peer_idx].name.c_str() ) != 0 ) {
+            SCHD_REPORT_ERROR( "cosim::part" ) << "Incorrect directory: " << peer_list[peer_idx].name;
+         }
+
+         peer_list.clear();
+         peer_list.push_back( parent );
+
+         part_idx = peer_idx + 1;
+
+         return part_idx;
+      }
+
+      // Parent
+      close( plan_fd[0] );
+      close( done_fd[1] );
+
+      peer_list[peer_idx].pid   = pid;
+      peer_list[peer_idx].fd_rd = done_fd[0];
+      peer_list[peer_idx].fd_wr = plan_fd[1];
+   } // for( std::size_t peer_idx = 0; peer_idx < peer_list.size(); peer_idx ++ )
+
+   part_idx = 0;
+
+   return part_idx;
+} // std::size_t cosim_part_c::fork_cores(
+
+void cosim_part_c::add_adapter(
+      cosim_adapter_c& adapter ) {
+   if( adpt_idx >= peer_list.size()) {
+      SCHD_REPORT_ERROR( "cosim::part" ) << "Incorrect number of adapters";
+   }
+
+   adapter.part_set(( part_idx == 0 ) ? cosim_adapter_c::PART_PLAN : cosim_adapter_c::PART_SIMD );
+
+   peer_list[adpt_idx ++].adapter_p = &adapter;
+} // void cosim_part_c::add_adapter(
+
+void cosim_part_c::msg_write(
+      int                                   fd,
+      bool                                  stop,
+      const cosim_adapter_c::dly_list_t&    dly_list ) {
+   std::string msg( sizeof( std::uint64_t ), '\0' ); // Space for the length
+
+   uint2bin( stop ? 1 : 0,     msg );
+   uint2bin( dly_list.size(),  msg );
+
+   BOOST_FOREACH( const cosim_adapter_c::dly_data_t& dly_el, dly_list ) {
+      uint2bin( time2val( dly_el.due ), msg );
+      pt2bin( dly_el.msg.get(), msg );
+   }
+
+   std::uint64_t msg_len = msg.size() - sizeof( std::uint64_t );
+   std::memcpy( &msg[0], &msg_len, sizeof( std::uint64_t ));
+
+   const char* pos = msg.data();
+   const char* end = msg.data() + msg.size();
+
+   while( pos != end ) {
+      ssize_t len = write( fd, pos, end - pos );
+
+      if( len < 0 && errno == EINTR ) {
+         continue;
+      }
+      else if( len <= 0 ) {
+         SCHD_REPORT_ERROR( "cosim::part" ) << "Write error: " << std::strerror( errno );
+      }
+
+      pos += len;
+   }
+} // void cosim_part_c::msg_write(
+
+void cosim_part_c::msg_read(
+      int                                   fd,
+      bool&                                 stop,
+      cosim_adapter_c::dly_list_t&          dly_list ) {
+   std::uint64_t msg_len = 0;
+   std::string   msg;
+
+   for( int part = 0; part < 2; part ++ ) { // Length, then message
+      char*       pos = ( part == 0 ) ? reinterpret_cast<char*>( &msg_len ) : &msg[0];
+      const char* end = pos + (( part == 0 ) ? sizeof( std::uint64_t ) : msg.size());
+
+      while( pos != end ) {
+         ssize_t len = read( fd, pos, end - pos );
+
+         if( len < 0 && errno == EINTR ) {
+            continue;
+         }
+         else if( len <= 0 ) {
+            SCHD_REPORT_ERROR( "cosim::part" ) << "Read error: " << (( len == 0 ) ? "end of file" : std::strerror( errno ));
+         }
+
+         pos += len;
+      }
+
+      msg.resize( msg_len );
+   }
+
+   const char* pos = msg.data();
+   const char* end = msg.data() + msg.size();
+
+   std::uint64_t stop_val;
+   std::uint64_t dly_num;
+
+   dly_list.clear();
+
+   bool msg_ok = bin2uint( pos, end, stop_val ) &&
+                 bin2uint( pos, end, dly_num );
+
+   for( std::uint64_t dly_idx = 0; msg_ok && dly_idx < dly_num; dly_idx ++ ) {
+      std::uint64_t   due_val;
+      boost_pt::ptree dly_pt;
+
+      msg_ok = bin2uint( pos, end, due_val ) &&
+               bin2pt(   pos, end, dly_pt );
+
+      if( msg_ok ) {
+         dly_list.push_back( cosim_adapter_c::dly_data_t());
+         dly_list.back().due = val2time( due_val );
+         dly_list.back().msg = cosim_msg_pool.make( dly_pt );
+      }
+   }
+
+   if( !msg_ok || pos != end ) {
+      SCHD_REPORT_ERROR( "cosim::part" ) << "Incorrect message";
+   }
+
+   stop = ( stop_val != 0 );
+} // void cosim_part_c::msg_read(
+
+void cosim_part_c::run(
+      const sc_core::sc_time& end_time,
+      const cosim_beat_c&     beat ) {
+   if( adpt_idx != peer_list.size()) {
+      SCHD_REPORT_ERROR( "cosim::part" ) << "Incorrect number of adapters";
+   }
+
+   if( end_time == sc_core::SC_ZERO_TIME ) {
+      SCHD_REPORT_ERROR( "cosim::part" ) << "Parallel mode requires simulation end time";
+   }
+
+   // Packets which cross the partition boundary within a window are due not earlier than
+   // the end of the window, so the window can not be longer than the shortest latency
+   sc_core::sc_time window = end_time;
+
+   BOOST_FOREACH( const peer_data_t& peer_el, peer_list ) {
+      if( peer_el.adapter_p->latency_get() == sc_core::SC_ZERO_TIME ) {
+         SCHD_REPORT_ERROR( "cosim::part" ) << peer_el.adapter_p->name() << " Parallel mode requires adapter latency";
+      }
+
+      window = std::min( window, peer_el.adapter_p->latency_get() );
+   }
+
+   SCHD_REPORT_INFO( "cosim::part" ) << "Process: " << part_idx << " Window: " << window.to_string();
+
+   cosim_adapter_c::dly_list_t dly_list;
+   bool                        stop      = false;
+   bool                        peer_stop = false; // Early stop requested by a core process
+
+   while( !stop ) {
+      sc_core::sc_time wndw_end = std::min( sc_core::sc_time_stamp() + window, end_time );
+
+      // Kernel paused by the heartbeat completes the window, so that the processes stay in step
+      while( sc_core::sc_time_stamp() < wndw_end ) {
+         sc_core::sc_start(
+               wndw_end - sc_core::sc_time_stamp());
+      }
+
+      if( part_idx == 0 ) { // Parent: packets from planner to the cores, then completions back
+         stop = ( sc_core::sc_time_stamp() >= end_time ) || beat.stop_get() || peer_stop;
+
+         BOOST_FOREACH( peer_data_t& peer_el, peer_list ) {
+            peer_el.adapter_p->part_plan_take( dly_list );
+            msg_write( peer_el.fd_wr, stop, dly_list );
+         }
+
+         BOOST_FOREACH( peer_data_t& peer_el, peer_list ) {
+            bool done_stop;
+
+            msg_read( peer_el.fd_rd, done_stop, dly_list );
+            peer_el.adapter_p->part_done_give( dly_list );
+
+            peer_stop = peer_stop || done_stop;
+         }
+      }
+      else { // Child: the same in the reverse order. Early stop of the core is requested from the parent
+         peer_data_t& peer_el = peer_list.front();
+
+         msg_read( peer_el.fd_rd, stop, dly_list );
+         peer_el.adapter_p->part_plan_give( dly_list );
+
+         peer_el.adapter_p->part_done_take( dly_list );
+         msg_write( peer_el.fd_wr, stop || beat.stop_get(), dly_list );
+      }
+   } // while( !stop )
+
+   BOOST_FOREACH( peer_data_t& peer_el, peer_list ) {
+      close( peer_el.fd_rd );
+      close( peer_el.fd_wr );
+
+      if( part_idx != 0 ) {
+         continue;
+      }
+
+      int status = 0;
+
+      if( waitpid( peer_el.pid, &status, 0 ) != peer_el.pid ||
+          !WIFEXITED( status ) ||
+          WEXITSTATUS( status ) != 0 ) {
+         SCHD_REPORT_ERROR( "cosim::part" ) << "Core process failed: " << peer_el.name;
+      }
+   }
+} // void cosim_part_c::run(
+
+} // namespace schd
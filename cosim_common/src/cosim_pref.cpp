@@ -0,0 +1,212 @@
+/*
+ * cosim_pref.cpp
+ *
+ *  Description: Preferences of the co-simulation with the binary cache
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <boost/foreach.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include "cosim_pref.h"
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+// Global instance
+cosim_pref_c cosim_pref;
+
+const std::string cosim_pref_c::cache_magic = "COSIMPC2";
+
+void cosim_pref_c::load(
+      const std::string&                   file_name ) {
+   std::ifstream file_str( file_name, std::ios::in | std::ios::binary );
+
+   if( !file_str.is_open()) {
+      SCHD_REPORT_ERROR( "cosim::pref" ) << "Can not open: " << file_name;
+   }
+
+   std::string file_data(( std::istreambuf_iterator<char>( file_str )),
+                           std::istreambuf_iterator<char>());
+
+   std::uint64_t file_hash  = 14695981039346656037ULL;              // FNV-1a offset basis
+
+   for( const char ch : file_data ) {
+      file_hash ^= static_cast<unsigned char>( ch );
+      file_hash *= 1099511628211ULL;                                // FNV-1a prime
+   }
+
+   std::string cache_name = file_name + ".cache";
+
+   if( cache_read( cache_name, file_hash )) {
+      SCHD_REPORT_INFO( "cosim::pref" ) << "Preferences from cache: " << cache_name;
+      return;
+   }
+
+   try {
+      std::istringstream data_str( file_data );
+      pref_pt.clear();
+      boost_pt::read_json( data_str, pref_pt );
+      exec_expand( pref_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::pref" ) << file_name << " " << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::pref" ) << file_name << " " << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::pref" ) << file_name << " Unexpected";
+   }
+
+   cache_write( cache_name, file_hash );
+} // void cosim_pref_c::load(
+
+void cosim_pref_c::set(
+      const boost_pt::ptree&               pt ) {
+   pref_pt = pt;
+
+   try {
+      exec_expand( pref_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::pref" ) << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::pref" ) << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::pref" ) << "Unexpected";
+   }
+} // void cosim_pref_c::set(
+
+void cosim_pref_c::exec_expand(
+      boost_pt::ptree&                     pref_pt ) {
+   boost::optional<boost_pt::ptree&> exec_list_p = pref_pt.get_child_optional( "executors" );
+
+   if( !exec_list_p.is_initialized()) {
+      return;
+   }
+
+   bool rep_found = false;
+
+   BOOST_FOREACH( const boost_pt::ptree::value_type& exec_el, exec_list_p.get()) {
+      rep_found = rep_found || ( exec_el.second.find( "replicate" ) != exec_el.second.not_found());
+   }
+
+   if( !rep_found ) {
+      return;
+   }
+
+   // Executors of the core templates: "replicate" copies with %1% in the name replaced by the index
+   boost_pt::ptree exec_list_pt;
+
+   BOOST_FOREACH( boost_pt::ptree::value_type& exec_el, exec_list_p.get()) {
+      boost::optional<std::size_t> rep_num_p = exec_el.second.get_optional<std::size_t>( "replicate" );
+
+      if( !rep_num_p.is_initialized()) {
+         exec_list_pt.push_back( std::make_pair( "", boost_pt::ptree()));
+         exec_list_pt.back().second.swap( exec_el.second );
+         continue;
+      }
+
+      exec_el.second.erase( "replicate" );
+
+      std::string name = exec_el.second.get<std::string>( "name" );
+
+      for( std::size_t rep_idx = 0; rep_idx < rep_num_p.get(); rep_idx ++ ) {
+         exec_list_pt.push_back( std::make_pair( "", exec_el.second ));
+         exec_list_pt.back().second.put( "name", boost::algorithm::replace_all_copy( name, "%1%", std::to_string( rep_idx )));
+      }
+   }
+
+   exec_list_p.get().swap( exec_list_pt );
+} // void cosim_pref_c::exec_expand(
+
+boost::optional<const boost_pt::ptree&> cosim_pref_c::get_pref(
+      const std::string&                   pref_name ) const {
+   return pref_pt.get_child_optional( pref_name );
+} // cosim_pref_c::get_pref(
+
+bool cosim_pref_c::cache_read(
+      const std::string&                   cache_name,
+      std::uint64_t                        file_hash ) {
+   int cache_fd = open( cache_name.c_str(), O_RDONLY );
+
+   if( cache_fd < 0 ) {
+      return false;
+   }
+
+   struct stat cache_stat;
+   std::size_t head_size = cache_magic.size() + sizeof( std::uint64_t );
+
+   if( fstat( cache_fd, &cache_stat ) != 0 ||
+       static_cast<std::size_t>( cache_stat.st_size ) < head_size ) {
+      close( cache_fd );
+      return false;
+   }
+
+   void* map_p = mmap( nullptr, cache_stat.st_size, PROT_READ, MAP_PRIVATE, cache_fd, 0 );
+   close( cache_fd );
+
+   if( map_p == MAP_FAILED ) {
+      return false;
+   }
+
+   const char*   pos = static_cast<const char*>( map_p );
+   const char*   end = pos + cache_stat.st_size;
+   std::uint64_t cache_hash;
+
+   std::memcpy( &cache_hash, pos + cache_magic.size(), sizeof( std::uint64_t ));
+
+   bool cache_ok = ( cache_magic.compare( 0, cache_magic.size(), pos, cache_magic.size()) == 0 &&
+                     cache_hash == file_hash );
+
+   if( cache_ok ) {
+      pos += head_size;
+      cache_ok = bin2pt( pos, end, pref_pt ) && pos == end;
+   }
+
+   munmap( map_p, cache_stat.st_size );
+
+   if( !cache_ok ) {
+      pref_pt.clear();
+   }
+
+   return cache_ok;
+} // bool cosim_pref_c::cache_read(
+
+void cosim_pref_c::cache_write(
+      const std::string&                   cache_name,
+      std::uint64_t                        file_hash ) {
+   std::string cache_data = cache_magic;
+
+   cache_data.append( reinterpret_cast<const char*>( &file_hash ), sizeof( std::uint64_t ));
+   pt2bin( pref_pt, cache_data );
+
+   // Concurrent runs (sweep workers) see either the old or the complete new cache
+   std::string   temp_name = cache_name + "." + std::to_string( getpid());
+   std::ofstream cache_str( temp_name, std::ios::out | std::ios::binary | std::ios::trunc );
+
+   if( !cache_str.is_open()) { // Cache is optional
+      return;
+   }
+
+   cache_str.write( cache_data.data(), cache_data.size());
+   cache_str.close();
+
+   if( !cache_str.good() ||
+       std::rename( temp_name.c_str(), cache_name.c_str()) != 0 ) {
+      std::remove( temp_name.c_str());
+   }
+} // void cosim_pref_c::cache_write(
+
+} // namespace schd
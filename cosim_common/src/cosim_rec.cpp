@@ -0,0 +1,342 @@
+/*
+ * cosim_rec.cpp
+ *
+ *  Description: Record and replay of the traffic on the adapter boundary
+ */
+
+#include <cstring>
+#include <iterator>
+#include "cosim_rec.h"
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+// Global instance
+cosim_rec_c cosim_rec;
+
+namespace {
+   const char rec_magic[] = "COSIMRC1";
+   const std::size_t rec_magic_size = sizeof( rec_magic ) - 1;
+}
+
+cosim_rec_c::~cosim_rec_c(
+      void ) {
+   close();
+} // cosim_rec_c::~cosim_rec_c(
+
+void cosim_rec_c::init(
+      boost::optional<const boost_pt::ptree&> cosim_pref_p ) {
+   if( !cosim_pref_p.is_initialized()) {
+      return;
+   }
+
+   boost::optional<const boost_pt::ptree&> rec_pref_p  = cosim_pref_p.get().get_child_optional( "record" );
+   boost::optional<const boost_pt::ptree&> rply_pref_p = cosim_pref_p.get().get_child_optional( "replay" );
+
+   if( rec_pref_p.is_initialized() && rply_pref_p.is_initialized()) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << "Record and replay can not be used together";
+   }
+
+   std::string rply_file;
+
+   try {
+      if( rec_pref_p.is_initialized()) {
+         file_name = rec_pref_p.get().get<std::string>( "file", "cosim_rec.crec" );
+         rec_en    = true;
+      }
+
+      if( rply_pref_p.is_initialized()) {
+         rply_file = rply_pref_p.get().get<std::string>( "file", "cosim_rec.crec" );
+
+         std::string mode_str = rply_pref_p.get().get<std::string>( "mode" );
+
+         if( mode_str == "simd" ) {
+            rply_mode = RPLY_SIMD;
+         }
+         else if( mode_str == "planner" ) {
+            rply_mode = RPLY_PLAN;
+         }
+         else {
+            SCHD_REPORT_ERROR( "cosim::rec" ) << "Incorrect replay mode: " << mode_str;
+         }
+      }
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << "Incorrect record preferences: " << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << "Unexpected";
+   }
+
+   if( rply_mode != RPLY_NONE ) {
+      load( rply_file );
+   }
+
+   if( !rec_en ) {
+      return;
+   }
+
+   file_str.open( file_name, std::ios::out | std::ios::binary | std::ios::trunc );
+
+   if( !file_str.is_open()) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << "Can not open: " << file_name;
+   }
+
+   // Header: magic and time resolution
+   double res_sec = sc_core::sc_get_time_resolution().to_seconds();
+
+   rec_data.assign( rec_magic, rec_magic_size );
+   rec_data.append( reinterpret_cast<const char*>( &res_sec ), sizeof( res_sec ));
+} // void cosim_rec_c::init(
+
+bool cosim_rec_c::enabled(
+      void ) const {
+   return rec_en;
+} // bool cosim_rec_c::enabled(
+
+cosim_rec_c::rply_mode_t cosim_rec_c::rply_get(
+      void ) const {
+   return rply_mode;
+} // cosim_rec_c::rply_mode_t cosim_rec_c::rply_get(
+
+std::size_t cosim_rec_c::name_add(
+      const std::string&                   name ) {
+   if( !rec_en ) {
+      return rec_none;
+   }
+
+   rec_data.push_back( 'N' );
+   uint2bin( name.size(), rec_data );
+   rec_data.append( name );
+
+   return name_num ++;
+} // std::size_t cosim_rec_c::name_add(
+
+void cosim_rec_c::rec_head(
+      char                                 type,
+      std::size_t                          name_idx,
+      const sc_core::sc_time&              time ) {
+   rec_data.push_back( type );
+   uint2bin( name_idx,         rec_data );
+   uint2bin( time2val( time ), rec_data );
+} // void cosim_rec_c::rec_head(
+
+void cosim_rec_c::busw(
+      std::size_t                          core_idx,
+      const sc_core::sc_time&              time,
+      const boost_pt::ptree&               pt ) {
+   if( core_idx == rec_none ) {
+      return;
+   }
+
+   rec_head( 'W', core_idx, time );
+   pt2bin( pt, rec_data );
+   rec_flush( false );
+} // void cosim_rec_c::busw(
+
+void cosim_rec_c::evnt(
+      std::size_t                          core_idx,
+      const sc_core::sc_time&              time,
+      const boost_pt::ptree&               pt ) {
+   if( core_idx == rec_none ) {
+      return;
+   }
+
+   rec_head( 'E', core_idx, time );
+   pt2bin( pt, rec_data );
+   rec_flush( false );
+} // void cosim_rec_c::evnt(
+
+void cosim_rec_c::disp(
+      std::size_t                          exec_idx,
+      const sc_core::sc_time&              time ) {
+   if( exec_idx == rec_none ) {
+      return;
+   }
+
+   rec_head( 'D', exec_idx, time );
+   rec_flush( false );
+} // void cosim_rec_c::disp(
+
+void cosim_rec_c::done(
+      std::size_t                          exec_idx,
+      const sc_core::sc_time&              time ) {
+   if( exec_idx == rec_none ) {
+      return;
+   }
+
+   rec_head( 'C', exec_idx, time );
+   rec_flush( false );
+} // void cosim_rec_c::done(
+
+void cosim_rec_c::rec_flush(
+      bool                                 force ) {
+   if( !force && rec_data.size() < rec_flush_size ) {
+      return;
+   }
+
+   file_str.write( rec_data.data(), rec_data.size());
+   rec_data.clear();
+} // void cosim_rec_c::rec_flush(
+
+void cosim_rec_c::close(
+      void ) {
+   if( !rec_en ) {
+      return;
+   }
+
+   rec_flush( true );
+   file_str.close();
+
+   rec_en = false;
+
+   SCHD_REPORT_INFO( "cosim::rec" ) << "Recording: " << file_name;
+} // void cosim_rec_c::close(
+
+void cosim_rec_c::load(
+      const std::string&                   rply_file ) {
+   std::ifstream rply_str( rply_file, std::ios::in | std::ios::binary );
+
+   if( !rply_str.is_open()) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << "Can not open: " << rply_file;
+   }
+
+   std::string data(( std::istreambuf_iterator<char>( rply_str )),
+                      std::istreambuf_iterator<char>());
+
+   const char* pos = data.data();
+   const char* end = data.data() + data.size();
+   double      res_sec;
+
+   if( data.size() < rec_magic_size + sizeof( res_sec ) ||
+       std::memcmp( pos, rec_magic, rec_magic_size ) != 0 ) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << "Incorrect recording: " << rply_file;
+   }
+
+   std::memcpy( &res_sec, pos + rec_magic_size, sizeof( res_sec ));
+   pos += rec_magic_size + sizeof( res_sec );
+
+   if( res_sec != sc_core::sc_get_time_resolution().to_seconds()) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << "Time resolution of the recording does not match: " << rply_file;
+   }
+
+   std::vector<std::string> name_list;
+   bool                     rec_ok = true;
+
+   while( rec_ok && pos != end ) {
+      char          type = *pos ++;
+      std::uint64_t name_idx;
+      std::uint64_t time_val;
+
+      if( type == 'N' ) {
+         std::uint64_t name_size;
+
+         rec_ok = bin2uint( pos, end, name_size ) &&
+                  name_size <= static_cast<std::uint64_t>( end - pos );
+
+         if( rec_ok ) {
+            name_list.push_back( std::string( pos, name_size ));
+            pos += name_size;
+         }
+
+         continue;
+      }
+
+      rec_ok = bin2uint( pos, end, name_idx ) &&
+               bin2uint( pos, end, time_val ) &&
+               name_idx < name_list.size();
+
+      if( !rec_ok ) {
+         break;
+      }
+
+      const std::string& name = name_list[name_idx];
+
+      if( type == 'W' ) {
+         core_data_t& core_data = core_list[name];
+
+         core_data.word_list.push_back( word_data_t());
+         core_data.word_list.back().time = val2time( time_val );
+
+         rec_ok = bin2pt( pos, end, core_data.word_list.back().pt );
+      }
+      else if( type == 'E' ) {
+         boost_pt::ptree evnt_pt;
+
+         core_list[name].evnt_num ++;
+
+         rec_ok = bin2pt( pos, end, evnt_pt );
+      }
+      else if( type == 'D' ) {
+         exec_list[name].disp_time = val2time( time_val );
+      }
+      else if( type == 'C' ) {
+         exec_data_t& exec_data = exec_list[name];
+
+         exec_data.lat_list.push_back( val2time( time_val ) - exec_data.disp_time );
+      }
+      else {
+         rec_ok = false;
+      }
+   } // while( rec_ok && pos != end )
+
+   if( !rec_ok ) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << "Incorrect recording: " << rply_file;
+   }
+
+   for( std::unordered_map<std::string, core_data_t>::const_iterator core_it = core_list.begin();
+        core_it != core_list.end();
+        core_it ++ ) {
+      core_word_num += core_it->second.word_list.empty() ? 0 : 1;
+   }
+
+   SCHD_REPORT_INFO( "cosim::rec" ) << "Replay: " << rply_file
+                                    << " Cores: "     << core_list.size()
+                                    << " Executors: " << exec_list.size();
+} // void cosim_rec_c::load(
+
+cosim_rec_c::word_list_t& cosim_rec_c::word_list_get(
+      const std::string&                   core_name ) {
+   return core_list[core_name].word_list;
+} // cosim_rec_c::word_list_t& cosim_rec_c::word_list_get(
+
+std::size_t cosim_rec_c::evnt_num_get(
+      const std::string&                   core_name ) const {
+   std::unordered_map<std::string, core_data_t>::const_iterator core_it = core_list.find( core_name );
+
+   return ( core_it == core_list.end()) ? 0 : core_it->second.evnt_num;
+} // std::size_t cosim_rec_c::evnt_num_get(
+
+void cosim_rec_c::core_done(
+      const std::string&                   core_name,
+      std::size_t                          evnt_num ) {
+   SCHD_REPORT_INFO( "cosim::rec" ) << core_name
+                                    << " Replay done. Events: " << evnt_num
+                                    << " Recorded: " << evnt_num_get( core_name );
+
+   if( ++ core_done_num == core_word_num ) {
+      sc_core::sc_stop();
+   }
+} // void cosim_rec_c::core_done(
+
+sc_core::sc_time cosim_rec_c::lat_next(
+      const std::string&                   exec_name ) {
+   exec_data_t& exec_data = exec_list[exec_name];
+
+   if( !exec_data.lat_list.empty()) {
+      exec_data.lat_last = exec_data.lat_list.front();
+      exec_data.lat_en   = true;
+      exec_data.lat_list.pop_front();
+   }
+   else if( !exec_data.lat_en ) {
+      SCHD_REPORT_ERROR( "cosim::rec" ) << "No recorded jobs of: " << exec_name;
+   }
+
+   return exec_data.lat_last;
+} // sc_core::sc_time cosim_rec_c::lat_next(
+
+} // namespace schd
@@ -0,0 +1,228 @@
+/*
+ * cosim_router.cpp
+ *
+ *  Description: Planner->core router for co-simulation
+ */
+
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <boost/foreach.hpp>
+#include "cosim_router.h"
+#include "schd_conv_ptree.h"
+#include "schd_assert.h"
+#include "schd_report.h"
+
+namespace schd {
+
+SC_HAS_PROCESS( schd::cosim_router_c );
+cosim_router_c::cosim_router_c(
+      sc_core::sc_module_name nm )
+   : sc_core::sc_module( nm )
+   , vi( "vi" )
+   , vo( "vo" ) {
+
+   // Process registrations
+   SC_THREAD( rout_thrd ); // Thread for data forwarding
+} // cosim_router_c::cosim_router_c(
+
+void cosim_router_c::init(
+      boost::optional<const boost_pt::ptree&> pref_p ) {
+
+   boost::optional<const boost_pt::ptree&> src_list_p = pref_p.get().get_child_optional( "src_list" );
+   boost::optional<const boost_pt::ptree&> dst_list_p = pref_p.get().get_child_optional( "dst_list" );
+
+   if( !src_list_p.is_initialized() ||
+       !dst_list_p.is_initialized() ||
+       src_list_p.get().size() == 0 ||
+       dst_list_p.get().size() == 0 ) {
+      SCHD_REPORT_ERROR( "cosim::router" ) << name() << " Incorrect structure";
+   }
+
+   trie_list.resize( 1 ); // Root
+
+   std::size_t dst_idx = 0;
+
+   BOOST_FOREACH( const boost_pt::ptree::value_type& dst_el, dst_list_p.get()) {
+      if( !dst_el.first.empty()) {
+         SCHD_REPORT_ERROR( "cosim::router" ) << name() << " Incorrect structure";
+      }
+
+      boost::optional<std::string> mask_p = dst_el.second.get_optional<std::string>( "mask" );
+
+      if( !mask_p.is_initialized() ) {
+         SCHD_REPORT_ERROR( "cosim::router" ) << name() << " Incorrect mask for destination: " << dst_idx;
+      }
+
+      std::string prefix;
+
+      if( mask_prefix( mask_p.get(), prefix )) { // Add to the trie
+         std::size_t node_idx = 0;
+
+         BOOST_FOREACH( const char ch, prefix ) {
+            std::vector<std::pair<char, std::size_t>>::iterator next_it = std::find_if(
+                  trie_list[node_idx].next_list.begin(),
+                  trie_list[node_idx].next_list.end(),
+                  [ch]( const std::pair<char, std::size_t>& el )->bool {
+                     return el.first == ch; } );
+
+            if( next_it == trie_list[node_idx].next_list.end()) {
+               trie_list[node_idx].next_list.push_back( std::make_pair( ch, trie_list.size() ));
+               node_idx = trie_list.size();
+               trie_list.push_back( trie_node_t());
+            }
+            else {
+               node_idx = next_it->second;
+            }
+         }
+
+         // The first matching mask wins as it does with regex list
+         trie_list[node_idx].dst_idx = std::min( trie_list[node_idx].dst_idx, dst_idx );
+      }
+      else { // Keep as regex
+         rgxp_data_t rgxp_data;
+
+         try {
+            rgxp_data.dst_idx = dst_idx;
+            rgxp_data.rgxp    = boost::regex( mask_p.get() );
+         }
+         catch( const std::exception& err ) {
+            SCHD_REPORT_ERROR( "cosim::router" ) << name() << " Incorrect mask: " << mask_p.get() << " " << err.what();
+         }
+
+         rgxp_list.push_back( rgxp_data );
+      }
+
+      dst_idx ++;
+   } // BOOST_FOREACH( const boost_pt::ptree::value_type& dst_el, dst_list_p.get())
+
+   SCHD_REPORT_INFO( "cosim::router" ) << name()
+                                       << " Prefix masks: " << dst_idx - rgxp_list.size()
+                                       << " Regex masks: "  << rgxp_list.size();
+
+   vi.init( src_list_p.get().size() );
+   vo.init( dst_list_p.get().size() );
+} // void cosim_router_c::init(
+
+bool cosim_router_c::mask_prefix(
+      const std::string& mask,
+      std::string&       prefix ) {
+   static const char  *meta_chr = ".[]{}()*+?|^$\\";
+   static const std::string tail_str = ".*$";
+
+   prefix.clear();
+
+   if( mask.size() < 1 + tail_str.size() ||
+       mask[0] != '^' ||
+       mask.compare( mask.size() - tail_str.size(), tail_str.size(), tail_str ) != 0 ) {
+      return false;
+   }
+
+   for( std::size_t pos = 1; pos < mask.size() - tail_str.size(); pos ++ ) {
+      char ch = mask[pos];
+
+      if( ch == '\\' ) { // Escaped metacharacter is a literal
+         pos ++;
+
+         if( pos == mask.size() - tail_str.size() ||
+             std::strchr( meta_chr, mask[pos] ) == nullptr ) {
+            return false;
+         }
+
+         prefix.push_back( mask[pos] );
+      }
+      else if( std::strchr( meta_chr, ch ) != nullptr ) {
+         return false;
+      }
+      else {
+         prefix.push_back( ch );
+      }
+   }
+
+   return true;
+} // cosim_router_c::mask_prefix(
+
+std::size_t cosim_router_c::route(
+      const std::string& dst ) const {
+   std::size_t node_idx = 0;
+   std::size_t dst_idx  = trie_list[0].dst_idx;
+
+   // Lowest index among all the prefix masks along the path
+   BOOST_FOREACH( const char ch, dst ) {
+      const std::vector<std::pair<char, std::size_t>>& next_list = trie_list[node_idx].next_list;
+      std::vector<std::pair<char, std::size_t>>::const_iterator next_it = next_list.begin();
+
+      while( next_it != next_list.end() && next_it->first != ch ) {
+         next_it ++;
+      }
+
+      if( next_it == next_list.end()) {
+         break;
+      }
+
+      node_idx = next_it->second;
+      dst_idx  = std::min( dst_idx, trie_list[node_idx].dst_idx );
+   }
+
+   // Only the regex masks which precede the prefix match need to be checked
+   BOOST_FOREACH( const rgxp_data_t& rgxp_el, rgxp_list ) {
+      if( rgxp_el.dst_idx > dst_idx ) {
+         break;
+      }
+
+      if( boost::regex_match( dst, rgxp_el.rgxp )) {
+         return rgxp_el.dst_idx;
+      }
+   }
+
+   return dst_idx;
+} // cosim_router_c::route(
+
+void cosim_router_c::rout_thrd(
+      void ) {
+   schd::schd_sig_ptree_c pt_sig;
+
+   sc_core::sc_event_or_list vi_evnt_list;
+
+   for( std::size_t vi_idx = 0; vi_idx < vi.size(); vi_idx ++ ) {
+      vi_evnt_list |= vi[vi_idx]->data_written_event();
+   }
+
+   for(;;) {
+      bool vi_idle = true;
+
+      for( std::size_t vi_idx = 0; vi_idx < vi.size(); vi_idx ++ ) {
+         while( vi[vi_idx]->nb_read( pt_sig )) {
+            vi_idle = false;
+
+            const boost_pt::ptree& pt = pt_sig.get();
+
+            boost_pt::ptree::const_assoc_iterator dst_it = pt.find( "dst" );
+
+            if( dst_it == pt.not_found()) {
+               std::string pt_str;
+
+               SCHD_REPORT_ERROR( "cosim::router" ) << name()
+                                                    << " Incorrect data format: "
+                                                    << pt2str( pt, pt_str );
+            }
+
+            std::size_t dst_idx = route( dst_it->second.data() );
+
+            if( dst_idx == dst_none ) {
+               SCHD_REPORT_ERROR( "cosim::router" ) << name()
+                                                    << " Unresolved destination: "
+                                                    << dst_it->second.data();
+            }
+
+            vo[dst_idx]->write( pt_sig );
+         }
+      }
+
+      if( vi_idle ) {
+         sc_core::wait( vi_evnt_list );
+      }
+   } // for(;;)
+} // void cosim_router_c::rout_thrd(
+
+} // namespace schd
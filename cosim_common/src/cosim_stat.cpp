@@ -0,0 +1,178 @@
+/*
+ * cosim_stat.cpp
+ *
+ *  Description: Statistics of the co-simulation
+ */
+
+#include <boost/foreach.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include "cosim_stat.h"
+#include "cosim_adapter.h"
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+void cosim_hist_c::add(
+      std::uint64_t                        value ) {
+   std::size_t bin_idx = 0;
+
+   while( value != 0 ) {
+      value >>= 1;
+      bin_idx ++;
+   }
+
+   if( bin_idx >= bin_list.size()) {
+      bin_list.resize( bin_idx + 1, 0 );
+   }
+
+   bin_list[bin_idx] ++;
+} // void cosim_hist_c::add(
+
+boost_pt::ptree& cosim_hist_c::get(
+      boost_pt::ptree&                     hist_pt ) const {
+   hist_pt.clear();
+
+   for( std::size_t bin_idx = 0; bin_idx < bin_list.size(); bin_idx ++ ) {
+      if( bin_list[bin_idx] == 0 ) {
+         continue;
+      }
+
+      boost_pt::ptree bin_pt;
+
+      bin_pt.put( "min",   ( bin_idx == 0 ) ? 0 : ( std::uint64_t( 1 ) << ( bin_idx - 1 )));
+      bin_pt.put( "count", bin_list[bin_idx] );
+
+      hist_pt.push_back( std::make_pair( "", bin_pt ));
+   }
+
+   return hist_pt;
+} // boost_pt::ptree& cosim_hist_c::get(
+
+SC_HAS_PROCESS( schd::cosim_stat_c );
+cosim_stat_c::cosim_stat_c(
+      sc_core::sc_module_name nm )
+   : sc_core::sc_module( nm ) {
+
+   // Process registrations
+   SC_THREAD( smpl_thrd ); // Periodic sampling
+} // cosim_stat_c::cosim_stat_c(
+
+void cosim_stat_c::init(
+      boost::optional<const boost_pt::ptree&> cosim_pref_p ) {
+   if( !cosim_pref_p.is_initialized()) {
+      return;
+   }
+
+   boost::optional<const boost_pt::ptree&> stat_pref_p = cosim_pref_p.get().get_child_optional( "stats" );
+
+   if( !stat_pref_p.is_initialized()) {
+      return;
+   }
+
+   try {
+      file_name   = stat_pref_p.get().get<std::string>( "file", "cosim_stats.json" );
+      smpl_period = str2time( stat_pref_p.get().get<std::string>( "period", "0" ));
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::stat" ) << name() << " " << err.what();
+   }
+
+   if( smpl_period != sc_core::SC_ZERO_TIME ) {
+      std::string smpl_name = file_name + ".samples";
+
+      smpl_str.open( smpl_name, std::ios::out | std::ios::trunc );
+
+      if( !smpl_str.is_open()) {
+         SCHD_REPORT_ERROR( "cosim::stat" ) << name() << " Can not open: " << smpl_name;
+      }
+   }
+
+   stat_en = true;
+} // void cosim_stat_c::init(
+
+bool cosim_stat_c::enabled(
+      void ) const {
+   return stat_en;
+} // bool cosim_stat_c::enabled(
+
+void cosim_stat_c::add_adapter(
+      cosim_adapter_c&                     adapter ) {
+   if( !stat_en ) {
+      return;
+   }
+
+   adapter.stat_enable();
+   adpt_list.push_back( &adapter );
+} // void cosim_stat_c::add_adapter(
+
+boost_pt::ptree& cosim_stat_c::stat_get(
+      boost_pt::ptree&                     stat_pt ) {
+   boost_pt::ptree adpt_list_pt;
+
+   stat_pt.clear();
+   stat_pt.put( "time", sc_core::sc_time_stamp().to_seconds());
+
+   BOOST_FOREACH( cosim_adapter_c* adpt_p, adpt_list ) {
+      boost_pt::ptree adpt_pt;
+
+      adpt_list_pt.push_back( std::make_pair( "", adpt_p->stat_get( adpt_pt )));
+   }
+
+   stat_pt.add_child( "adapters", adpt_list_pt );
+
+   boost_pt::ptree pool_pt;
+
+   stat_pt.add_child( "msg_pool", cosim_msg_pool.stat_get( pool_pt ));
+
+   return stat_pt;
+} // boost_pt::ptree& cosim_stat_c::stat_get(
+
+void cosim_stat_c::smpl_thrd(
+      void ) {
+   if( !stat_en || smpl_period == sc_core::SC_ZERO_TIME ) {
+      return;
+   }
+
+   boost_pt::ptree stat_pt;
+
+   for(;;) {
+      sc_core::wait( smpl_period );
+
+      boost_pt::write_json( smpl_str, stat_get( stat_pt ), false );
+
+      // The sampling alone doesn't keep the simulation running
+      if( !sc_core::sc_pending_activity()) {
+         return;
+      }
+   }
+} // void cosim_stat_c::smpl_thrd(
+
+void cosim_stat_c::dump(
+      void ) {
+   if( !stat_en ) {
+      return;
+   }
+
+   boost_pt::ptree stat_pt;
+
+   try {
+      boost_pt::write_json( file_name, stat_get( stat_pt ));
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::stat" ) << name() << " " << err.what();
+   }
+
+   smpl_str.close();
+
+   SCHD_REPORT_INFO( "cosim::stat" ) << name() << " Statistics: " << file_name;
+} // void cosim_stat_c::dump(
+
+void cosim_stat_c::flush(
+      void ) {
+   if( smpl_str.is_open()) {
+      smpl_str.flush();
+   }
+} // void cosim_stat_c::flush(
+
+} // namespace schd
@@ -0,0 +1,280 @@
+/*
+ * cosim_stream.cpp
+ *
+ *  Description: Streaming dump of the co-simulation packets
+ */
+
+#include <chrono>
+#include <cstring>
+#include <boost/foreach.hpp>
+#include "cosim_stream.h"
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+// Global instance
+cosim_stream_c cosim_stream;
+
+const std::string cosim_stream_c::stream_magic = "COSIMST1";
+
+cosim_stream_c::~cosim_stream_c(
+      void ) {
+   close();
+} // cosim_stream_c::~cosim_stream_c(
+
+void cosim_stream_c::init(
+      boost::optional<const boost_pt::ptree&> cosim_pref_p ) {
+   if( !cosim_pref_p.is_initialized()) {
+      return;
+   }
+
+   boost::optional<const boost_pt::ptree&> strm_pref_p = cosim_pref_p.get().get_child_optional( "stream" );
+
+   if( !strm_pref_p.is_initialized()) {
+      return;
+   }
+
+   std::size_t slot_num = 0;
+
+   try {
+      file_name = strm_pref_p.get().get<std::string>( "file", "cosim_dump.cstr" );
+      chan_mask = boost::regex( strm_pref_p.get().get<std::string>( "mask", ".*" ));
+      slot_num  = std::stoul( strm_pref_p.get().get<std::string>( "slots", "4096" ));
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::stream" ) << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::stream" ) << "Incorrect stream preferences: " << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::stream" ) << "Unexpected";
+   }
+
+   if( slot_num == 0 ) {
+      SCHD_REPORT_ERROR( "cosim::stream" ) << "Incorrect number of slots";
+   }
+
+   file_str.open( file_name, std::ios::out | std::ios::binary | std::ios::trunc );
+
+   if( !file_str.is_open()) {
+      SCHD_REPORT_ERROR( "cosim::stream" ) << "Can not open: " << file_name;
+   }
+
+   // Header: magic and time resolution
+   double res_sec = sc_core::sc_get_time_resolution().to_seconds();
+
+   file_str.write( stream_magic.data(), stream_magic.size());
+   file_str.write( reinterpret_cast<const char*>( &res_sec ), sizeof( res_sec ));
+
+   slot_list.resize( slot_num );
+   strm_en = true;
+
+   writ_thread = std::thread( &cosim_stream_c::writ_thrd, this );
+} // void cosim_stream_c::init(
+
+bool cosim_stream_c::enabled(
+      void ) const {
+   return strm_en;
+} // bool cosim_stream_c::enabled(
+
+std::size_t cosim_stream_c::chan_add(
+      const std::string&                   chan_name ) {
+   if( !strm_en || !boost::regex_match( chan_name, chan_mask )) {
+      return chan_none;
+   }
+
+   rec_buf.clear();
+   rec_buf.push_back( rec_chan );
+   uint2bin( chan_num, rec_buf );
+   uint2bin( chan_name.size(), rec_buf );
+   rec_buf.append( chan_name );
+
+   push();
+
+   return chan_num ++;
+} // std::size_t cosim_stream_c::chan_add(
+
+void cosim_stream_c::write(
+      std::size_t                          chan_idx,
+      const boost_pt::ptree&               pt ) {
+   rec_buf.clear();
+   rec_buf.push_back( rec_pckt );
+   uint2bin( chan_idx, rec_buf );
+   uint2bin( time2val( sc_core::sc_time_stamp()), rec_buf );
+   pt2bin( pt, rec_buf );
+
+   push();
+} // void cosim_stream_c::write(
+
+void cosim_stream_c::push(
+      void ) {
+   std::size_t head = slot_head.load( std::memory_order_relaxed );
+
+   // Queue is full: wait for the writer. This bounds the memory
+   if( head - slot_tail.load( std::memory_order_acquire ) == slot_list.size()) {
+      full_num ++;
+
+      while( head - slot_tail.load( std::memory_order_acquire ) == slot_list.size()) {
+         std::this_thread::yield();
+      }
+   }
+
+   // Slot strings keep their capacity, so there are no allocations in the steady state
+   slot_list[head % slot_list.size()].swap( rec_buf );
+   slot_head.store( head + 1, std::memory_order_release );
+} // void cosim_stream_c::push(
+
+void cosim_stream_c::writ_thrd(
+      void ) {
+   for(;;) {
+      std::size_t tail = slot_tail.load( std::memory_order_relaxed );
+      std::size_t head = slot_head.load( std::memory_order_acquire );
+
+      if( tail == head ) {
+         if( writ_stop.load( std::memory_order_acquire ) &&
+             head == slot_head.load( std::memory_order_acquire )) {
+            break;
+         }
+
+         std::this_thread::sleep_for( std::chrono::microseconds( 100 ));
+         continue;
+      }
+
+      for( ; tail != head; tail ++ ) {
+         std::string& slot = slot_list[tail % slot_list.size()];
+
+         file_str.write( slot.data(), slot.size());
+         slot.clear();
+
+         slot_tail.store( tail + 1, std::memory_order_release );
+      }
+   } // for(;;)
+
+   file_str.flush();
+} // void cosim_stream_c::writ_thrd(
+
+void cosim_stream_c::close(
+      void ) {
+   if( !strm_en ) {
+      return;
+   }
+
+   writ_stop.store( true, std::memory_order_release );
+   writ_thread.join();
+   file_str.close();
+
+   strm_en = false;
+
+   SCHD_REPORT_INFO( "cosim::stream" ) << "Stream: " << file_name
+                                       << " Channels: " << chan_num
+                                       << " Queue full: " << full_num;
+} // void cosim_stream_c::close(
+
+cosim_dump_c::cosim_dump_c(
+      const std::string&                   chan_name ) {
+   if( cosim_stream.enabled()) {
+      chan_idx = cosim_stream.chan_add( chan_name );
+   }
+   else {
+      buf_p.reset( new schd_dump_buf_c<boost_pt::ptree>( chan_name ));
+   }
+} // cosim_dump_c::cosim_dump_c(
+
+void cosim_dump_c::write(
+      const boost_pt::ptree&               pt ) {
+   if( buf_p ) {
+      buf_p->write( pt, BUF_WRITE_LAST );
+   }
+   else if( chan_idx != cosim_stream_c::chan_none ) {
+      cosim_stream.write( chan_idx, pt );
+   }
+} // void cosim_dump_c::write(
+
+SC_HAS_PROCESS( schd::cosim_stream_play_c );
+cosim_stream_play_c::cosim_stream_play_c(
+      sc_core::sc_module_name nm )
+   : sc_core::sc_module( nm ) {
+
+   // Process registrations
+   SC_THREAD( play_thrd );
+} // cosim_stream_play_c::cosim_stream_play_c(
+
+void cosim_stream_play_c::init(
+      const std::string&                   file_name ) {
+   std::ifstream file_str( file_name, std::ios::in | std::ios::binary );
+
+   if( !file_str.is_open()) {
+      SCHD_REPORT_ERROR( "cosim::stream" ) << name() << " Can not open: " << file_name;
+   }
+
+   strm_data.assign(( std::istreambuf_iterator<char>( file_str )),
+                      std::istreambuf_iterator<char>());
+
+   const std::string& magic   = cosim_stream_c::stream_magic;
+   double             res_sec = 0.0;
+
+   if( strm_data.size() < magic.size() + sizeof( res_sec ) ||
+       strm_data.compare( 0, magic.size(), magic ) != 0 ) {
+      SCHD_REPORT_ERROR( "cosim::stream" ) << name() << " Incorrect stream: " << file_name;
+   }
+
+   std::memcpy( &res_sec, strm_data.data() + magic.size(), sizeof( res_sec ));
+
+   if( res_sec != sc_core::sc_get_time_resolution().to_seconds()) {
+      SCHD_REPORT_ERROR( "cosim::stream" ) << name() << " Time resolution of the stream differs from the preferences";
+   }
+} // void cosim_stream_play_c::init(
+
+void cosim_stream_play_c::play_thrd(
+      void ) {
+   std::vector<std::unique_ptr<schd_dump_buf_c<boost_pt::ptree>>> buf_list;
+   boost_pt::ptree pt;
+
+   const char* pos = strm_data.data() + cosim_stream_c::stream_magic.size() + sizeof( double );
+   const char* end = strm_data.data() + strm_data.size();
+
+   while( pos != end ) {
+      char          rec_type = *pos ++;
+      std::uint64_t chan_idx = 0;
+      std::uint64_t val      = 0;
+      bool          rec_ok   = bin2uint( pos, end, chan_idx ) && bin2uint( pos, end, val );
+
+      if( rec_ok && rec_type == cosim_stream_c::rec_chan ) { // val: name length
+         rec_ok = ( chan_idx == buf_list.size() && static_cast<std::uint64_t>( end - pos ) >= val );
+
+         if( rec_ok ) {
+            buf_list.emplace_back( new schd_dump_buf_c<boost_pt::ptree>( std::string( pos, val )));
+            pos += val;
+         }
+      }
+      else if( rec_ok && rec_type == cosim_stream_c::rec_pckt ) { // val: time
+         rec_ok = ( chan_idx < buf_list.size() && bin2pt( pos, end, pt ));
+
+         if( rec_ok ) {
+            sc_core::sc_time rec_time = val2time( val );
+
+            if( rec_time > sc_core::sc_time_stamp()) {
+               sc_core::wait( rec_time - sc_core::sc_time_stamp());
+            }
+
+            buf_list[chan_idx]->write( pt, BUF_WRITE_LAST );
+         }
+      }
+      else {
+         rec_ok = false;
+      }
+
+      if( !rec_ok ) {
+         SCHD_REPORT_ERROR( "cosim::stream" ) << name() << " Incorrect record at: "
+                                              << ( pos - strm_data.data());
+      }
+   } // while( pos != end )
+
+   SCHD_REPORT_INFO( "cosim::stream" ) << name() << " Channels: " << buf_list.size();
+
+   sc_core::sc_stop();
+} // void cosim_stream_play_c::play_thrd(
+
+} // namespace schd
@@ -0,0 +1,386 @@
+/*
+ * cosim_sweep.cpp
+ *
+ *  Description: Parameter sweep runner
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <unordered_set>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <boost/foreach.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include "cosim_sweep.h"
+#include "cosim_pref.h"
+#include "schd_report.h"
+
+namespace schd {
+
+// Global instance
+cosim_sweep_c cosim_sweep;
+
+const std::string cosim_sweep_c::pref_name = "pref.json";
+const std::string cosim_sweep_c::summ_name = "summary.json";
+const std::string cosim_sweep_c::log_name  = "console.log";
+
+bool cosim_sweep_c::enabled(
+      void ) const {
+   return work_en;
+} // bool cosim_sweep_c::enabled(
+
+boost_pt::ptree& cosim_sweep_c::pref_find(
+      boost_pt::ptree&                     pref_pt,
+      const std::string&                   path ) {
+   boost_pt::ptree* node_p  = &pref_pt;
+   std::size_t      seg_pos = 0;
+
+   while( seg_pos <= path.size()) {
+      std::size_t seg_end = path.find( '.', seg_pos );
+
+      if( seg_end == std::string::npos ) {
+         seg_end = path.size();
+      }
+
+      std::string seg = path.substr( seg_pos, seg_end - seg_pos );
+
+      if( seg.empty()) {
+         SCHD_REPORT_ERROR( "cosim::sweep" ) << "Incorrect path: " << path;
+      }
+
+      boost_pt::ptree::assoc_iterator child_it = node_p->find( seg );
+
+      if( child_it != node_p->not_found()) { // Key
+         node_p = &( child_it->second );
+      }
+      else { // Element of the list with this name
+         boost_pt::ptree* list_el_p = nullptr;
+
+         BOOST_FOREACH( boost_pt::ptree::value_type& list_el, *node_p ) {
+            if( list_el.first.empty() &&
+                list_el.second.get<std::string>( "name", "" ) == seg ) {
+               list_el_p = &( list_el.second );
+               break;
+            }
+         }
+
+         if( list_el_p == nullptr ) {
+            SCHD_REPORT_ERROR( "cosim::sweep" ) << "Path segment " << seg << " is neither a key nor a list element name: " << path;
+         }
+
+         node_p = list_el_p;
+      }
+
+      seg_pos = seg_end + 1;
+   } // while( seg_pos <= path.size())
+
+   return *node_p;
+} // boost_pt::ptree& cosim_sweep_c::pref_find(
+
+void cosim_sweep_c::pref_put(
+      boost_pt::ptree&                     pref_pt,
+      const std::string&                   path,
+      const std::string&                   value ) {
+   pref_find( pref_pt, path ).data() = value;
+} // void cosim_sweep_c::pref_put(
+
+void cosim_sweep_c::scen_add(
+      const boost_pt::ptree&               sweep_pt ) {
+   std::vector<scen_data_t> base_list;
+
+   boost::optional<const boost_pt::ptree&> scen_list_p = sweep_pt.get_child_optional( "scenarios" );
+   boost::optional<const boost_pt::ptree&> grid_p      = sweep_pt.get_child_optional( "grid" );
+
+   if( scen_list_p.is_initialized()) {
+      BOOST_FOREACH( const boost_pt::ptree::value_type& scen_el, scen_list_p.get()) {
+         boost::optional<std::string>            name_p = scen_el.second.get_optional<std::string>( "name" );
+         boost::optional<const boost_pt::ptree&> set_p  = scen_el.second.get_child_optional( "set" );
+
+         if( !scen_el.first.empty() ||
+             !name_p.is_initialized()) {
+            SCHD_REPORT_ERROR( "cosim::sweep" ) << "Incorrect structure of scenarios";
+         }
+
+         base_list.push_back( scen_data_t());
+         base_list.back().name = name_p.get();
+
+         if( set_p.is_initialized()) {
+            base_list.back().set_pt = set_p.get();
+         }
+      }
+   }
+
+   if( base_list.empty()) {
+      base_list.push_back( scen_data_t());
+      base_list.back().name = "base";
+   }
+
+   // Cartesian product of the grid values for each scenario
+   std::size_t grid_num = 1;
+
+   if( grid_p.is_initialized()) {
+      BOOST_FOREACH( const boost_pt::ptree::value_type& grid_el, grid_p.get()) {
+         if( grid_el.second.empty()) {
+            SCHD_REPORT_ERROR( "cosim::sweep" ) << "Incorrect grid values: " << grid_el.first;
+         }
+
+         grid_num *= grid_el.second.size();
+      }
+   }
+
+   BOOST_FOREACH( const scen_data_t& base_el, base_list ) {
+      for( std::size_t grid_idx = 0; grid_idx < grid_num; grid_idx ++ ) {
+         scen_list.push_back( base_el );
+
+         if( !grid_p.is_initialized()) {
+            continue;
+         }
+
+         scen_list.back().name += "_" + std::to_string( grid_idx );
+
+         std::size_t val_idx = grid_idx;
+
+         BOOST_FOREACH( const boost_pt::ptree::value_type& grid_el, grid_p.get()) {
+            boost_pt::ptree::const_iterator val_it = grid_el.second.begin();
+            std::advance( val_it, val_idx % grid_el.second.size());
+            val_idx /= grid_el.second.size();
+
+            scen_list.back().set_pt.push_back( std::make_pair( grid_el.first, boost_pt::ptree( val_it->second.data())));
+         }
+      }
+   }
+
+   std::unordered_set<std::string> name_set;
+
+   BOOST_FOREACH( const scen_data_t& scen_el, scen_list ) {
+      if( !name_set.insert( scen_el.name ).second ) {
+         SCHD_REPORT_ERROR( "cosim::sweep" ) << "Duplicate scenario: " << scen_el.name;
+      }
+   }
+} // void cosim_sweep_c::scen_add(
+
+bool cosim_sweep_c::run(
+      const std::string&                   base_file,
+      const std::string&                   sweep_file,
+      std::string&                         pref_file ) {
+   boost_pt::ptree base_pt;
+   boost_pt::ptree sweep_pt;
+
+   // Shared between all the scenarios: parsed once
+   try {
+      boost_pt::read_json( base_file,  base_pt  );
+      boost_pt::read_json( sweep_file, sweep_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::sweep" ) << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::sweep" ) << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::sweep" ) << "Unexpected";
+   }
+
+   scen_add( sweep_pt );
+
+   // Paths are checked before any worker is launched
+   BOOST_FOREACH( const scen_data_t& scen_el, scen_list ) {
+      BOOST_FOREACH( const boost_pt::ptree::value_type& set_el, scen_el.set_pt ) {
+         pref_find( base_pt, set_el.first );
+      }
+   }
+
+   std::size_t job_max  = std::stoul( sweep_pt.get<std::string>( "jobs", "0" ));
+   std::string res_file = sweep_pt.get<std::string>( "results", "sweep_results.json" );
+
+   if( job_max == 0 ) { // Host cores
+      long cpu_num = sysconf( _SC_NPROCESSORS_ONLN );
+      job_max = ( cpu_num > 0 ) ? static_cast<std::size_t>( cpu_num ) : 1;
+   }
+
+   SCHD_REPORT_INFO( "cosim::sweep" ) << "Scenarios: " << scen_list.size() << " Jobs: " << job_max;
+
+   std::vector<std::chrono::steady_clock::time_point> start_list( scen_list.size());
+
+   std::size_t scen_next = 0;
+   std::size_t job_num   = 0;
+
+   while( scen_next < scen_list.size() || job_num != 0 ) {
+      // Launch the workers
+      while( scen_next < scen_list.size() && job_num < job_max ) {
+         scen_data_t& scen_el = scen_list[scen_next];
+
+         start_list[scen_next] = std::chrono::steady_clock::now();
+
+         int pid = work_fork( scen_el.name );
+
+         if( pid == 0 ) { // Worker
+            BOOST_FOREACH( const boost_pt::ptree::value_type& set_el, scen_el.set_pt ) {
+               pref_put( base_pt, set_el.first, set_el.second.data());
+            }
+
+            work_pref( base_pt, pref_file );
+
+            work_en = true;
+
+            return true;
+         }
+
+         scen_el.pid = pid;
+         scen_next ++;
+         job_num ++;
+      } // while( scen_next < scen_list.size() && job_num < job_max )
+
+      // Collect a worker
+      int status = 0;
+      int pid    = waitpid( -1, &status, 0 );
+
+      if( pid < 0 ) {
+         if( errno == EINTR ) {
+            continue;
+         }
+
+         SCHD_REPORT_ERROR( "cosim::sweep" ) << "Wait error: " << std::strerror( errno );
+      }
+
+      for( std::size_t scen_idx = 0; scen_idx < scen_next; scen_idx ++ ) {
+         if( scen_list[scen_idx].pid != pid ) {
+            continue;
+         }
+
+         scen_list[scen_idx].pid      = -1;
+         scen_list[scen_idx].status   = WIFEXITED( status ) ? WEXITSTATUS( status ) : -1;
+         scen_list[scen_idx].wall_sec = std::chrono::duration<double>(
+               std::chrono::steady_clock::now() - start_list[scen_idx] ).count();
+
+         SCHD_REPORT_INFO( "cosim::sweep" ) << "Done: " << scen_list[scen_idx].name
+                                            << " Status: " << scen_list[scen_idx].status;
+         job_num --;
+         break;
+      }
+   } // while( scen_next < scen_list.size() || job_num != 0 )
+
+   // Gather the summaries
+   boost_pt::ptree res_pt;
+   boost_pt::ptree run_list_pt;
+   std::size_t     fail_num = 0;
+
+   BOOST_FOREACH( const scen_data_t& scen_el, scen_list ) {
+      boost_pt::ptree run_pt;
+      boost_pt::ptree summ_pt;
+
+      run_pt.put( "name",     scen_el.name );
+      run_pt.put( "status",   scen_el.status );
+      run_pt.put( "wall_sec", scen_el.wall_sec );
+      run_pt.add_child( "set", scen_el.set_pt );
+
+      try {
+         boost_pt::read_json( scen_el.name + "/" + summ_name, summ_pt );
+         run_pt.add_child( "summary", summ_pt );
+      }
+      catch( const boost_pt::ptree_error& err ) { // Worker failed before the end of simulation
+         run_pt.put( "summary", "" );
+      }
+
+      if( scen_el.status != 0 ) {
+         fail_num ++;
+      }
+
+      run_list_pt.push_back( std::make_pair( "", run_pt ));
+   }
+
+   res_pt.put( "base",  base_file );
+   res_pt.put( "sweep", sweep_file );
+   res_pt.put( "failed", fail_num );
+   res_pt.add_child( "runs", run_list_pt );
+
+   try {
+      boost_pt::write_json( res_file, res_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::sweep" ) << err.what();
+   }
+
+   SCHD_REPORT_INFO( "cosim::sweep" ) << "Results: " << res_file << " Failed: " << fail_num;
+
+   return false;
+} // bool cosim_sweep_c::run(
+
+void cosim_sweep_c::summary(
+      void ) {
+   if( !work_en ) {
+      return;
+   }
+
+   summ_write();
+} // void cosim_sweep_c::summary(
+
+int cosim_sweep_c::work_fork(
+      const std::string&                   dir_name ) {
+   int pid = fork();
+
+   if( pid < 0 ) {
+      SCHD_REPORT_ERROR( "cosim::sweep" ) << "Fork error: " << std::strerror( errno );
+   }
+   else if( pid > 0 ) {
+      return pid;
+   }
+
+   if(( mkdir( dir_name.c_str(), 0755 ) != 0 && errno != EEXIST ) ||
+      chdir( dir_name.c_str() ) != 0 ) {
+      SCHD_REPORT_ERROR( "cosim::sweep" ) << "Incorrect directory: " << dir_name;
+   }
+
+   // Console output of the worker goes to the log file
+   int log_fd = open( log_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+
+   if( log_fd >= 0 ) {
+      std::fflush( stdout );
+      std::fflush( stderr );
+      dup2( log_fd, STDOUT_FILENO );
+      dup2( log_fd, STDERR_FILENO );
+      close( log_fd );
+   }
+
+   return 0;
+} // int cosim_sweep_c::work_fork(
+
+void cosim_sweep_c::work_pref(
+      const boost_pt::ptree&               pref_pt,
+      std::string&                         pref_file ) {
+   try {
+      boost_pt::write_json( pref_name, pref_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::sweep" ) << err.what();
+   }
+
+   // Parsed preferences are passed to the simulation as they are
+   cosim_pref.set( pref_pt );
+
+   pref_file = pref_name;
+} // void cosim_sweep_c::work_pref(
+
+void cosim_sweep_c::summ_write(
+      void ) {
+   boost_pt::ptree summ_pt;
+
+   summ_pt.put( "end_time",    sc_core::sc_time_stamp().to_string());
+   summ_pt.put( "end_sec",     sc_core::sc_time_stamp().to_seconds());
+   summ_pt.put( "delta_count", sc_core::sc_delta_count());
+
+   try {
+      boost_pt::write_json( summ_name, summ_pt );
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::sweep" ) << err.what();
+   }
+} // void cosim_sweep_c::summ_write(
+
+} // namespace schd
@@ -0,0 +1,301 @@
+/*
+ * cosim_trace.cpp
+ *
+ *  Description: Compact binary trace of the co-simulation signals
+ */
+
+#include <algorithm>
+#include <boost/foreach.hpp>
+#include "cosim_trace.h"
+#include "cosim_conv.h"
+#include "schd_report.h"
+
+namespace schd {
+
+// Global instance
+cosim_trace_c cosim_trace;
+
+cosim_trace_c::~cosim_trace_c(
+      void ) {
+   close();
+} // cosim_trace_c::~cosim_trace_c(
+
+void cosim_trace_c::init(
+      boost::optional<const boost_pt::ptree&> trace_pref_p ) {
+   if( !trace_pref_p.is_initialized()) {
+      return;
+   }
+
+   boost::optional<const boost_pt::ptree&> bin_pref_p = trace_pref_p.get().get_child_optional( "binary" );
+
+   if( !bin_pref_p.is_initialized()) {
+      return;
+   }
+
+   try {
+      file_name  = bin_pref_p.get().get<std::string>( "file", "cosim_trace.ctr" );
+      sig_mask   = boost::regex( bin_pref_p.get().get<std::string>( "mask", ".*" ));
+      chunk_size = std::stoul( bin_pref_p.get().get<std::string>( "chunk", "65536" ));
+
+      boost::optional<const boost_pt::ptree&> wndw_list_p = bin_pref_p.get().get_child_optional( "window" );
+
+      if( wndw_list_p.is_initialized()) {
+         BOOST_FOREACH( const boost_pt::ptree::value_type& wndw_el, wndw_list_p.get()) {
+            wndw_data_t wndw_data;
+
+            wndw_data.start = str2time( wndw_el.second.get<std::string>( "start" ));
+            wndw_data.stop  = str2time( wndw_el.second.get<std::string>( "stop"  ));
+
+            if( wndw_data.stop <= wndw_data.start ) {
+               SCHD_REPORT_ERROR( "cosim::trace" ) << "Incorrect window";
+            }
+
+            wndw_list.push_back( wndw_data );
+         }
+      }
+   }
+   catch( const boost_pt::ptree_error& err ) {
+      SCHD_REPORT_ERROR( "cosim::trace" ) << err.what();
+   }
+   catch( const std::exception& err ) {
+      SCHD_REPORT_ERROR( "cosim::trace" ) << "Incorrect trace preferences: " << err.what();
+   }
+   catch( ... ) {
+      SCHD_REPORT_ERROR( "cosim::trace" ) << "Unexpected";
+   }
+
+   std::sort(
+         wndw_list.begin(),
+         wndw_list.end(),
+         []( const wndw_data_t& el_a, const wndw_data_t& el_b )->bool {
+            return el_a.start < el_b.start; } );
+
+   file_str.open( file_name, std::ios::out | std::ios::binary | std::ios::trunc );
+
+   if( !file_str.is_open()) {
+      SCHD_REPORT_ERROR( "cosim::trace" ) << "Can not open: " << file_name;
+   }
+
+   // Header: magic and time resolution
+   std::string head_data = "COSIMTR1";
+   double      res_sec   = sc_core::sc_get_time_resolution().to_seconds();
+
+   head_data.append( reinterpret_cast<const char*>( &res_sec ), sizeof( res_sec ));
+   file_pos = head_data.size();
+
+   trce_en = true;
+
+   writ_thread = std::thread( &cosim_trace_c::writ_thrd, this );
+
+   file_push( head_data );
+} // void cosim_trace_c::init(
+
+bool cosim_trace_c::enabled(
+      void ) const {
+   return trce_en;
+} // bool cosim_trace_c::enabled(
+
+std::size_t cosim_trace_c::sig_add(
+      const std::string&                   sig_name ) {
+   if( !trce_en || !boost::regex_match( sig_name, sig_mask )) {
+      return sig_none;
+   }
+
+   sig_name_list.push_back( sig_name );
+   sig_val_list.push_back( 0 );
+   sig_prev_list.push_back( 0 );
+
+   return sig_name_list.size() - 1;
+} // std::size_t cosim_trace_c::sig_add(
+
+bool cosim_trace_c::wndw_check(
+      const sc_core::sc_time&              time ) {
+   if( wndw_list.empty()) {
+      return true;
+   }
+
+   while( wndw_idx < wndw_list.size() &&
+          time >= wndw_list[wndw_idx].stop ) {
+      wndw_idx ++;
+   }
+
+   return wndw_idx < wndw_list.size() &&
+          time >= wndw_list[wndw_idx].start;
+} // bool cosim_trace_c::wndw_check(
+
+void cosim_trace_c::rec_add(
+      std::size_t                          sig_idx,
+      std::uint64_t                        time_val ) {
+   std::uint64_t value = sig_val_list[sig_idx];
+
+   if( value == sig_prev_list[sig_idx] ) {
+      return;
+   }
+
+   uint2bin( time_val - chunk_last_val,         chunk_data );
+   uint2bin( sig_idx,                           chunk_data );
+   uint2bin( value ^ sig_prev_list[sig_idx],    chunk_data );
+
+   sig_prev_list[sig_idx] = value;
+   chunk_last_val = time_val;
+   chunk_rec_num ++;
+} // void cosim_trace_c::rec_add(
+
+void cosim_trace_c::chunk_start(
+      const sc_core::sc_time&              time ) {
+   chunk_open      = true;
+   chunk_start_val = time2val( time );
+   chunk_last_val  = chunk_start_val;
+   chunk_rec_num   = 0;
+
+   // The chunk starts with the values of all the signals
+   std::fill( sig_prev_list.begin(), sig_prev_list.end(), 0 );
+
+   for( std::size_t sig_idx = 0; sig_idx < sig_val_list.size(); sig_idx ++ ) {
+      rec_add( sig_idx, chunk_start_val );
+   }
+} // void cosim_trace_c::chunk_start(
+
+void cosim_trace_c::change(
+      std::size_t                          sig_idx,
+      std::uint64_t                        value ) {
+   if( sig_idx == sig_none ) {
+      return;
+   }
+
+   sig_val_list[sig_idx] = value;
+
+   const sc_core::sc_time& time = sc_core::sc_time_stamp();
+
+   if( !wndw_check( time )) {
+      if( chunk_open ) { // Window is over
+         chunk_push();
+      }
+
+      return;
+   }
+
+   if( !chunk_open ) { // Values of the signals are known since the start of the window
+      chunk_start(( wndw_list.empty() || wndw_last == wndw_idx ) ? time : wndw_list[wndw_idx].start );
+      wndw_last = wndw_idx;
+   }
+
+   rec_add( sig_idx, time2val( time ));
+
+   if( chunk_data.size() >= chunk_size ) {
+      chunk_push();
+   }
+} // void cosim_trace_c::change(
+
+void cosim_trace_c::chunk_push(
+      void ) {
+   std::string chunk_body;
+
+   uint2bin( chunk_start_val, chunk_body );
+   uint2bin( chunk_rec_num,   chunk_body );
+   chunk_body.append( chunk_data );
+
+   std::string chunk = "K";
+
+   uint2bin( chunk_body.size(), chunk );
+   chunk.append( chunk_body );
+
+   chunk_list.push_back( std::make_pair( chunk_start_val, file_pos ));
+   file_pos += chunk.size();
+
+   chunk_data.clear();
+   chunk_open = false;
+
+   file_push( chunk );
+} // void cosim_trace_c::chunk_push(
+
+void cosim_trace_c::file_push(
+      std::string&                         data ) {
+   std::unique_lock<std::mutex> chunk_lock( chunk_mtx );
+
+   // Bounded number of the chunks in memory
+   chunk_cv.wait( chunk_lock, [this]()->bool {
+      return chunk_pend_list.size() < chunk_pend_max; } );
+
+   chunk_pend_list.push_back( std::string());
+   chunk_pend_list.back().swap( data );
+
+   chunk_cv.notify_all();
+} // void cosim_trace_c::file_push(
+
+void cosim_trace_c::writ_thrd(
+      void ) {
+   for(;;) {
+      std::string data;
+
+      {
+         std::unique_lock<std::mutex> chunk_lock( chunk_mtx );
+
+         chunk_cv.wait( chunk_lock, [this]()->bool {
+            return !chunk_pend_list.empty() || writ_stop; } );
+
+         if( chunk_pend_list.empty()) { // Stop
+            break;
+         }
+
+         data.swap( chunk_pend_list.front());
+         chunk_pend_list.pop_front();
+
+         chunk_cv.notify_all();
+      }
+
+      file_str.write( data.data(), data.size());
+   } // for(;;)
+
+   file_str.flush();
+} // void cosim_trace_c::writ_thrd(
+
+void cosim_trace_c::close(
+      void ) {
+   if( !trce_en ) {
+      return;
+   }
+
+   if( chunk_open ) {
+      chunk_push();
+   }
+
+   // Index and footer
+   std::string   indx_data = "I";
+   std::uint64_t indx_pos  = file_pos;
+
+   uint2bin( sig_name_list.size(), indx_data );
+
+   BOOST_FOREACH( const std::string& sig_name, sig_name_list ) {
+      uint2bin( sig_name.size(), indx_data );
+      indx_data.append( sig_name );
+   }
+
+   uint2bin( chunk_list.size(), indx_data );
+
+   BOOST_FOREACH( const chunk_list_t::value_type& chunk_el, chunk_list ) {
+      uint2bin( chunk_el.first,  indx_data );
+      uint2bin( chunk_el.second, indx_data );
+   }
+
+   indx_data.append( reinterpret_cast<const char*>( &indx_pos ), sizeof( indx_pos ));
+
+   file_push( indx_data );
+
+   {
+      std::lock_guard<std::mutex> chunk_lock( chunk_mtx );
+      writ_stop = true;
+      chunk_cv.notify_all();
+   }
+
+   writ_thread.join();
+   file_str.close();
+
+   trce_en = false;
+
+   SCHD_REPORT_INFO( "cosim::trace" ) << "Trace: " << file_name
+                                      << " Signals: " << sig_name_list.size()
+                                      << " Chunks: " << chunk_list.size();
+} // void cosim_trace_c::close(
+
+} // namespace schd
@@ -2,7 +2,8 @@
  * simd_sys_scalar_run.cpp
  *
  *  Description:
- *    System components: Scalar processor dummy
+ *    System components: Scalar processor dummy.
+ *    In the replay of the SIMD side it drives the core with the recorded config words
  */
 
 #include <boost/random.hpp>
@@ -10,6 +11,7 @@
 #include "simd_assert.h"
 #include "simd_report.h"
 #include "simd_trace.h"
+#include "cosim_rec.h"
 
 namespace simd {
 
@@ -22,6 +24,61 @@ void simd_sys_scalar_c::init(
 void simd_sys_scalar_c::exec_thrd(
       void ) {
 
+   if( schd::cosim_rec.rply_get() != schd::cosim_rec_c::RPLY_SIMD ) {
+      for(;;) {
+         sc_core::wait();
+      } // for(;;)
+   }
+
+   // Name of the core is the first part of the hierarchical name
+   std::string core_name = name();
+
+   core_name = core_name.substr( 0, core_name.find( '.' ));
+
+   schd::cosim_rec_c::word_list_t& word_list = schd::cosim_rec.word_list_get( core_name );
+   std::size_t                     evnt_rec  = schd::cosim_rec.evnt_num_get( core_name );
+   std::size_t                     evnt_num  = 0;
+   simd_sig_ptree_c                sig;
+
+   if( word_list.empty()) { // Nothing was recorded for the core
+      for(;;) {
+         sc_core::wait();
+      } // for(;;)
+   }
+
+   for(;;) {
+      // Events and status are only counted
+      while( event_i->nb_read( sig )) {
+         evnt_num ++;
+      }
+
+      while( busr_i->nb_read( sig )) {
+      }
+
+      if( word_list.empty() && evnt_num >= evnt_rec ) {
+         break;
+      }
+
+      if( !word_list.empty() &&
+          word_list.front().time <= sc_core::sc_time_stamp()) {
+         busw_o->write( sig.set( word_list.front().pt )); // Write data to the output
+         word_list.pop_front();
+      }
+      else if( !word_list.empty()) {
+         sc_core::wait(
+               word_list.front().time - sc_core::sc_time_stamp(),
+               event_i->data_written_event() |
+               busr_i->data_written_event() );
+      }
+      else {
+         sc_core::wait(
+               event_i->data_written_event() |
+               busr_i->data_written_event() );
+      }
+   } // for(;;)
+
+   schd::cosim_rec.core_done( core_name, evnt_num );
+
    for(;;) {
       sc_core::wait();
    } // for(;;)